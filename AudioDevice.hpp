@@ -36,6 +36,10 @@ public:
 
   bool initialize (OpenMode mode, Channel channel);
 
+  // Called prior to initialization with the rate at which the stream will
+  // run, in frames per second; devices that care may override.
+  virtual void setSampleRate (unsigned) {}
+
   bool isSequential () const override {return true;}
 
   size_t bytesPerFrame () const {return sizeof (qint16) * (Mono == m_channel ? 1 : 2);}
@@ -49,11 +53,18 @@ protected:
   }
 
   void store (char const * source, size_t numFrames, qint16 * dest)
+  {
+    store (source, numFrames, dest, m_channel);
+  }
+
+  // As above, but taking the channel provided, rather than ours, from
+  // the frames; with stereo frames, each channel may be taken in turn.
+  void store (char const * source, size_t numFrames, qint16 * dest, Channel channel)
   {
     qint16 const * begin (reinterpret_cast<qint16 const *> (source));
     for ( qint16 const * i = begin; i != begin + numFrames * (bytesPerFrame () / sizeof (qint16)); i += bytesPerFrame () / sizeof (qint16))
       {
-	switch (m_channel)
+	switch (channel)
 	  {
 	  case Mono:
 	    *dest++ = *i;
@@ -65,7 +76,7 @@ protected:
 
 	  case Both:		// should be able to happen but if it
 				// does we'll take left
-	    Q_ASSERT (Both == m_channel);
+	    Q_ASSERT (Both == channel);
       [[fallthrough]];
 	  case Left:
 	    *dest++ = *i;
@@ -0,0 +1,301 @@
+#include "Channelizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <stdexcept>
+#include <vendor/Eigen/Dense>
+
+/******************************************************************************/
+// Filter Design
+/******************************************************************************/
+
+namespace
+{
+  // Channels of the filter bank are spaced 12kHz apart, and run at twice
+  // that, so a channel's passband may extend well past the midpoint to
+  // its neighbors; it need only stop short of the point at which anything
+  // aliased would land in the passband.
+  //
+  //   fpass       =  9100 Hz
+  //   fstop       = 14900 Hz
+
+  constexpr unsigned CHANNEL_SPACING = 12000;
+  constexpr unsigned CHANNEL_RATE    = 2 * CHANNEL_SPACING;
+  constexpr double   BANK_PASS_EDGE  =  9100.0;
+  constexpr double   BANK_STOP_EDGE  = 14900.0;
+
+  // The sideband of a dial frequency is centered 2800Hz above it, and is
+  // filtered by a lowpass, after having been tuned to baseband, that runs
+  // from 300Hz to 5300Hz above the dial frequency; the lower stopband
+  // edge keeps the opposite sideband from folding into the audio when we
+  // take the real part.
+  //
+  //   fpass       =  2500 Hz, either side of the center
+  //   fstop       =  3100 Hz, either side of the center
+  //
+  // Given the channel spacing, the sideband of any dial frequency lies
+  // within 6000Hz of the center of some channel, which together with the
+  // stopband width of 3100Hz keeps it within the channel passband.
+
+  constexpr double SIDEBAND_CENTER    = 2800.0;
+  constexpr double SIDEBAND_PASS_EDGE = 2500.0;
+  constexpr double SIDEBAND_STOP_EDGE = 3100.0;
+
+  static_assert(CHANNEL_SPACING / 2 + SIDEBAND_STOP_EDGE <= BANK_PASS_EDGE);
+  static_assert(CHANNEL_RATE - BANK_STOP_EDGE            >= BANK_PASS_EDGE);
+
+  //   Stop Atten  = 70   dB, for both
+
+  constexpr double ATTENUATION = 70.0;
+
+  // Modified Bessel function of the first kind, order zero, by its power
+  // series; converges quickly for the arguments a Kaiser window needs.
+
+  double
+  bessel(double const x)
+  {
+    double sum  = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; term > sum * 1e-12; ++k)
+    {
+      auto const t = x / (2.0 * k);
+      term *= t * t;
+      sum  += term;
+    }
+
+    return sum;
+  }
+
+  // Kaiser-windowed sinc lowpass, per Kaiser's estimate of the size, and
+  // rounded up to a multiple of the value provided; normalized for unity
+  // gain at DC, and reversed, so as to line up with a delay line, oldest
+  // sample first.
+
+  std::vector<float>
+  lowpass(double      const rate,
+          double      const passEdge,
+          double      const stopEdge,
+          std::size_t const multiple)
+  {
+    auto const width  = 2.0 * std::numbers::pi * (stopEdge - passEdge) / rate;
+    auto const beta   = 0.1102 * (ATTENUATION - 8.7);
+    auto const count  = static_cast<std::size_t>(std::ceil((ATTENUATION - 7.95) / (2.285 * width))) + 1;
+    auto const size   = (count + multiple - 1) / multiple * multiple;
+    auto const center = (size - 1) / 2.0;
+    auto const cutoff = (passEdge + stopEdge) / 2.0 / rate;
+    auto const scale  = bessel(beta);
+
+    std::vector<double> taps(size);
+
+    for (std::size_t n = 0; n < size; ++n)
+    {
+      auto const x    = n - center;
+      auto const r    = x / (center + 0.5);
+      auto const sinc = x == 0.0 ? 1.0 : std::sin(2.0 * std::numbers::pi * cutoff * x)
+                                       / (2.0 * std::numbers::pi * cutoff * x);
+
+      taps[n] = sinc * bessel(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / scale;
+    }
+
+    auto const gain = 1.0 / std::accumulate(taps.begin(), taps.end(), 0.0);
+
+    std::vector<float> result(size);
+
+    std::transform(taps.rbegin(), taps.rend(), result.begin(), [gain](double const tap)
+    {
+      return static_cast<float>(tap * gain);
+    });
+
+    return result;
+  }
+
+  // Real taps applied to a window of complex samples; two real dot products,
+  // the samples being interleaved real and imaginary parts.
+
+  std::complex<float>
+  filter(std::vector<float>  const & taps,
+         std::complex<float> const * window)
+  {
+    using Samples = Eigen::Map<Eigen::VectorXf const, 0, Eigen::InnerStride<2>>;
+    using Taps    = Eigen::Map<Eigen::VectorXf const>;
+
+    auto const size = static_cast<Eigen::Index>(taps.size());
+    auto const data = reinterpret_cast<float const *>(window);
+    auto const h    = Taps(taps.data(), size);
+
+    return {h.dot(Samples(data,     size)),
+            h.dot(Samples(data + 1, size))};
+  }
+}
+
+/******************************************************************************/
+// Implementation
+/******************************************************************************/
+
+Channelizer::Channelizer(unsigned         const   inputRate,
+                         std::vector<int> const & dials)
+  : m_inputRate(inputRate)
+  , m_dials    (dials)
+{
+  if (inputRate == 0 || inputRate % CHANNEL_RATE)
+  {
+    throw std::runtime_error("IQ sample rate must be a multiple of 24 kHz");
+  }
+
+  m_channels   = inputRate / CHANNEL_SPACING;
+  m_decimation = m_channels / 2;
+  m_prototype  = lowpass(inputRate, BANK_PASS_EDGE, BANK_STOP_EDGE, m_channels);
+  m_taps       = m_prototype.size();
+
+  m_delay.resize(2 * m_taps);
+  m_fft.resize(m_channels);
+  m_rotation.resize(m_channels);
+
+  for (std::size_t i = 0; i < m_channels; ++i)
+  {
+    m_rotation[i] = std::polar(1.0f, static_cast<float>(2.0 * std::numbers::pi * i / m_channels));
+  }
+
+  m_plan = FFTW::Plan(FFTW::Problem{FFTW::Problem::Kind::C2C, static_cast<int>(m_channels), FFTW_BACKWARD},
+                      m_fft.data(),
+                      m_fft.data());
+
+  if (!m_plan) throw std::runtime_error("Failed to create FFT plan");
+
+  m_sideband     = lowpass(CHANNEL_RATE, SIDEBAND_PASS_EDGE, SIDEBAND_STOP_EDGE, 1);
+  m_sidebandTaps = m_sideband.size();
+
+  // Each dial frequency takes the channel nearest to the center of its
+  // sideband; the sideband must be within the IQ passband.
+
+  auto const nyquist = inputRate / 2.0;
+
+  for (auto const dial : dials)
+  {
+    auto const center = dial + SIDEBAND_CENTER;
+
+    if (center - SIDEBAND_STOP_EDGE < -nyquist ||
+        center + SIDEBAND_STOP_EDGE >  nyquist)
+    {
+      throw std::runtime_error("dial frequency is outside of the IQ passband");
+    }
+
+    auto const index = static_cast<long>(std::lround(center / CHANNEL_SPACING));
+    auto const count = static_cast<long>(m_channels);
+
+    Tuner tuner;
+
+    tuner.channel = static_cast<std::size_t>((index % count + count) % count);
+    tuner.step    = (center - static_cast<double>(index * CHANNEL_SPACING)) / CHANNEL_RATE;
+    tuner.delay.resize(2 * m_sidebandTaps);
+
+    m_tuners.push_back(std::move(tuner));
+  }
+}
+
+void
+Channelizer::reset()
+{
+  std::fill(m_delay.begin(), m_delay.end(), Complex{});
+
+  m_write   = 0;
+  m_pending = 0;
+  m_time    = 0;
+
+  for (auto & tuner : m_tuners)
+  {
+    std::fill(tuner.delay.begin(), tuner.delay.end(), Complex{});
+
+    tuner.phase = 0.0;
+    tuner.shift = 0.0;
+    tuner.write = 0;
+    tuner.odd   = false;
+  }
+}
+
+void
+Channelizer::process(Complex                  const * const input,
+                     std::size_t                const         count,
+                     std::vector<std::vector<float>>        & outputs)
+{
+  outputs.resize(m_tuners.size());
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    m_delay[m_write]          = input[i];
+    m_delay[m_write + m_taps] = input[i];
+
+    if (++m_write == m_taps) m_write = 0;
+
+    // Every K / 2 inputs, the filter bank produces a sample of each
+    // channel. The window is the most recent m_taps inputs, oldest first;
+    // weighted by the prototype, it's folded into K partial sums, one per
+    // phase, and the inverse FFT of those is every channel at once.
+
+    if (++m_pending == m_decimation)
+    {
+      m_pending = 0;
+
+      std::fill(m_fft.begin(), m_fft.end(), Complex{});
+
+      auto const window = m_delay.data() + m_write;
+
+      for (std::size_t j = 0; j < m_taps; ++j)
+      {
+        m_fft[(m_taps - 1 - j) % m_channels] += m_prototype[j] * window[j];
+      }
+
+      fftwf_execute(m_plan);
+
+      tune(m_fft.data());
+
+      for (std::size_t t = 0; t < m_tuners.size(); ++t)
+      {
+        auto & tuner = m_tuners[t];
+
+        // The sideband filter is run on every other channel sample,
+        // decimating to 12kHz; the filtered sideband is then tuned back
+        // up by its center, and its real part is the audio.
+
+        if ((tuner.odd = !tuner.odd)) continue;
+
+        auto const value = filter(m_sideband, tuner.delay.data() + tuner.write)
+                         * std::polar(1.0f, static_cast<float>(2.0 * std::numbers::pi * tuner.shift));
+
+        tuner.shift += SIDEBAND_CENTER / OUTPUT_RATE;
+        tuner.shift -= std::floor(tuner.shift);
+
+        outputs[t].push_back(value.real());
+      }
+    }
+
+    if (++m_time == m_channels) m_time = 0;
+  }
+}
+
+// Take each dial frequency's channel from the filter bank output, undo the
+// rotation that the bank's decimation leaves the channel with, and tune the
+// center of the sideband to baseband, into the sideband filter delay line.
+
+void
+Channelizer::tune(Complex const * const channels)
+{
+  for (auto & tuner : m_tuners)
+  {
+    auto const rotation = m_rotation[(m_channels - tuner.channel * m_time % m_channels) % m_channels];
+    auto const sample   = channels[tuner.channel] * rotation
+                        * std::polar(1.0f, static_cast<float>(-2.0 * std::numbers::pi * tuner.phase));
+
+    tuner.phase += tuner.step;
+    tuner.phase -= std::floor(tuner.phase);
+
+    tuner.delay[tuner.write]                  = sample;
+    tuner.delay[tuner.write + m_sidebandTaps] = sample;
+
+    if (++tuner.write == m_sidebandTaps) tuner.write = 0;
+  }
+}
+
+/******************************************************************************/
@@ -0,0 +1,93 @@
+#ifndef CHANNELIZER_HPP__
+#define CHANNELIZER_HPP__
+#include <complex>
+#include <cstddef>
+#include <vector>
+#include "FFTWPlans.hpp"
+
+// Splits complex IQ, captured at a multiple of 24kHz, into any number of
+// 12kHz sub-bands, each of which is what a receiver tuned to a given dial
+// frequency would provide as upper sideband audio; dial frequencies are
+// relative to the center of the IQ passband.
+//
+// The first stage is a polyphase FFT filter bank, of K = rate / 12kHz
+// channels, spaced 12kHz apart and oversampled by two, such that each is
+// 24kHz of complex baseband, flat well past the midpoint to its neighbors;
+// the input is filtered once, by the prototype decomposed into K phases,
+// and a single K point FFT then yields every channel. However many dial
+// frequencies are requested, the cost of this stage is the same.
+//
+// Each dial frequency then takes the channel within which its sideband
+// lies entirely, tunes the sideband to baseband, filters off everything
+// else, and decimates to 12kHz, providing the real part, i.e., audio.
+
+class Channelizer final
+{
+public:
+
+  // Rate of the audio we provide.
+
+  static constexpr unsigned OUTPUT_RATE = 12000;
+
+  // Constructor; throws if the input rate isn't a multiple of 24kHz, or
+  // if the sideband of a dial frequency isn't within the IQ passband.
+
+  Channelizer(unsigned                 inputRate,
+              std::vector<int> const & dials);
+
+  // Accessors
+
+  unsigned                 inputRate() const { return m_inputRate; }
+  std::vector<int> const & dials()     const { return m_dials;     }
+
+  // Discard history, as for a discontinuity in the input.
+
+  void reset();
+
+  // Run IQ samples through the channelizer, appending the audio for each
+  // dial frequency to the corresponding output.
+
+  void process(std::complex<float>      const * input,
+               std::size_t                      count,
+               std::vector<std::vector<float>>  & outputs);
+
+private:
+
+  using Complex = std::complex<float>;
+
+  // Sideband filter and state for a dial frequency.
+
+  struct Tuner
+  {
+    std::size_t          channel;  // index into the FFT output
+    double               step;     // tuning, in cycles per channel sample
+    double               phase   = 0.0;
+    double               shift   = 0.0;
+    std::vector<Complex> delay;    // 2 * taps, doubled circular delay line
+    std::size_t          write   = 0;
+    bool                 odd     = false;
+  };
+
+  void tune(Complex const * channels);
+
+  // Data members
+
+  unsigned             m_inputRate;
+  std::vector<int>     m_dials;
+  std::size_t          m_channels;       // K
+  std::size_t          m_decimation;     // K / 2
+  std::size_t          m_taps;           // prototype taps, a multiple of K
+  std::vector<float>   m_prototype;      // reversed, oldest sample first
+  std::vector<Complex> m_delay;          // 2 * m_taps
+  std::size_t          m_write   = 0;
+  std::size_t          m_pending = 0;    // inputs since the last output
+  std::size_t          m_time    = 0;    // input sample count, modulo K
+  std::vector<Complex> m_rotation;       // K roots of unity
+  std::vector<Complex> m_fft;            // K, transformed in place
+  FFTW::Plan           m_plan;
+  std::size_t          m_sidebandTaps;
+  std::vector<float>   m_sideband;       // reversed
+  std::vector<Tuner>   m_tuners;
+};
+
+#endif
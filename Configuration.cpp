@@ -676,6 +676,7 @@ private:
   QAudioDevice next_audio_input_device_;
   AudioDevice::Channel audio_input_channel_;
   AudioDevice::Channel next_audio_input_channel_;
+  Frequency secondary_dial_frequency_;
 
   QAudioDevice audio_output_device_;
   QAudioDevice next_audio_output_device_;
@@ -715,6 +716,7 @@ bool Configuration::is_active () const {return m_->isVisible ();}
 
 QAudioDevice const& Configuration::audio_input_device () const {return m_->audio_input_device_;}
 AudioDevice::Channel Configuration::audio_input_channel () const {return m_->audio_input_channel_;}
+auto Configuration::secondary_dial_frequency () const -> Frequency {return m_->secondary_dial_frequency_;}
 QAudioDevice const& Configuration::audio_output_device () const {return m_->audio_output_device_;}
 AudioDevice::Channel Configuration::audio_output_channel () const {return m_->audio_output_channel_;}
 QAudioDevice const& Configuration::notification_audio_output_device () const {return m_->notification_audio_output_device_;}
@@ -1225,7 +1227,7 @@ Configuration::impl::impl (Configuration * self, QDir const& temp_directory,
     update_audio_channels(ui_->sound_input_combo_box,
                           ui_->sound_input_channel_combo_box,
                           ui_->sound_input_combo_box->currentIndex(),
-                          false);
+                          true);
     ui_->sound_input_channel_combo_box->setCurrentIndex(next_audio_input_channel_);
 
     QGuiApplication::restoreOverrideCursor();
@@ -1344,7 +1346,16 @@ Configuration::impl::impl (Configuration * self, QDir const& temp_directory,
     update_audio_channels(ui_->sound_input_combo_box,
                           ui_->sound_input_channel_combo_box,
                           index,
-                          false);
+                          true);
+  });
+
+  // The dial frequency of the second receiver matters only if there is one.
+
+  connect(ui_->sound_input_channel_combo_box,
+          static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+          [this](auto const index)
+  {
+    ui_->secondary_dial_line_edit->setEnabled(AudioDevice::Both == index);
   });
 
   connect(ui_->sound_output_combo_box,
@@ -1624,6 +1635,9 @@ void Configuration::impl::initialize_models ()
   ui_->tcp_max_connections_spin_box->setValue(tcpMaxConnections_);
   ui_->calibration_intercept_spin_box->setValue (calibration_.intercept);
   ui_->calibration_slope_ppm_spin_box->setValue (calibration_.slope_ppm);
+  if (secondary_dial_frequency_) ui_->secondary_dial_line_edit->frequency (secondary_dial_frequency_);
+  else                           ui_->secondary_dial_line_edit->clear ();
+  ui_->secondary_dial_line_edit->setEnabled (AudioDevice::Both == ui_->sound_input_channel_combo_box->currentIndex ());
 
   if (rig_params_.ptt_port.isEmpty ())
     {
@@ -1880,6 +1894,7 @@ void Configuration::impl::read_settings ()
   // retrieve audio channel info
   audio_input_channel_ = AudioDevice::fromString (settings_->value ("AudioInputChannel", "Mono").toString ());
   audio_output_channel_ = AudioDevice::fromString (settings_->value ("AudioOutputChannel", "Mono").toString ());
+  secondary_dial_frequency_ = settings_->value ("RX2DialFreq", QVariant::fromValue<Frequency> (0)).value<Frequency> ();
 
   transmit_directed_ = settings_->value ("TransmitDirected", true).toBool();
   autoreply_on_at_startup_ = settings_->value ("AutoreplyOnAtStartup", true).toBool ();
@@ -2017,7 +2032,7 @@ Configuration::impl::find_audio_devices()
     update_audio_channels(ui_->sound_input_combo_box,
                           ui_->sound_input_channel_combo_box,
                           ui_->sound_input_combo_box->currentIndex(),
-                          false);
+                          true);
     ui_->sound_input_channel_combo_box->setCurrentIndex(next_audio_input_channel_);
   }
 
@@ -2178,6 +2193,7 @@ void Configuration::impl::write_settings ()
   settings_->setValue ("TCPEnabled", tcpEnabled_);
   settings_->setValue ("TCPMaxConnections", tcpMaxConnections_);
   settings_->setValue ("CalibrationIntercept", calibration_.intercept);
+  settings_->setValue ("RX2DialFreq", QVariant::fromValue (secondary_dial_frequency_));
   settings_->setValue ("CalibrationSlopePPM", calibration_.slope_ppm);
   settings_->setValue ("pwrBandTxMemory", pwrBandTxMemory_);
   settings_->setValue ("pwrBandTuneMemory", pwrBandTuneMemory_);
@@ -2633,7 +2649,7 @@ void Configuration::impl::accept ()
   {
     next_audio_input_channel_ = selected_channel;
   }
-  Q_ASSERT (next_audio_input_channel_ <= AudioDevice::Right);
+  Q_ASSERT (next_audio_input_channel_ <= AudioDevice::Both);
 
   if (auto const selected_channel  = static_cast<AudioDevice::Channel>(ui_->sound_output_channel_combo_box->currentIndex());
                  selected_channel != next_audio_output_channel_)
@@ -2729,6 +2745,7 @@ void Configuration::impl::accept ()
   save_directory_.setPath(ui_->save_path_display_label->text ());
   calibration_.intercept = ui_->calibration_intercept_spin_box->value ();
   calibration_.slope_ppm = ui_->calibration_slope_ppm_spin_box->value ();
+  secondary_dial_frequency_ = ui_->secondary_dial_line_edit->frequency ();
   pwrBandTxMemory_ = ui_->checkBoxPwrBandTxMemory->isChecked ();
   pwrBandTuneMemory_ = ui_->checkBoxPwrBandTuneMemory->isChecked ();
   opCall_=ui_->opCallEntry->text();
@@ -81,6 +81,7 @@ public:
 
   QAudioDevice const& audio_input_device () const;
   AudioDevice::Channel audio_input_channel () const;
+  Frequency secondary_dial_frequency () const; // of the other channel when the input channel is both; 0 if unknown
   QAudioDevice const& audio_output_device () const;
   AudioDevice::Channel audio_output_channel () const;
   QAudioDevice const& notification_audio_output_device () const;
@@ -0,0 +1,134 @@
+#include "Decimator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <stdexcept>
+
+/******************************************************************************/
+// Filter Design
+/******************************************************************************/
+
+namespace
+{
+  // The lowpass FIR is a Kaiser-windowed sinc, designed for the input
+  // rate when the decimator is constructed. Passband edge is a little
+  // above the highest frequency we decode; stopband edge is the point
+  // at which anything aliased would land above the passband edge, so
+  // the transition band aliases only onto itself.
+  //
+  //   fpass       = 5000 Hz
+  //   fstop       = 7000 Hz
+  //   Stop Atten  = 60   dB
+
+  constexpr double PASS_EDGE   = 5000.0;
+  constexpr double STOP_EDGE   = 7000.0;
+  constexpr double ATTENUATION = 60.0;
+
+  // Limit on the interpolation factor; bounds the size of the prototype
+  // filter, which is a multiple of it.
+
+  constexpr std::size_t MAX_UP = 160;
+
+  // Modified Bessel function of the first kind, order zero, by its power
+  // series; converges quickly for the arguments a Kaiser window needs.
+
+  double
+  bessel(double const x)
+  {
+    double sum  = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; term > sum * 1e-12; ++k)
+    {
+      auto const t = x / (2.0 * k);
+      term *= t * t;
+      sum  += term;
+    }
+
+    return sum;
+  }
+}
+
+/******************************************************************************/
+// Implementation
+/******************************************************************************/
+
+bool
+Decimator::supports(unsigned const inputRate)
+{
+  return inputRate >= 2 * STOP_EDGE &&
+         OUTPUT_RATE / std::gcd(inputRate, OUTPUT_RATE) <= MAX_UP;
+}
+
+Decimator::Decimator(unsigned const inputRate)
+  : m_inputRate(inputRate)
+{
+  if (!supports(inputRate))
+  {
+    throw std::runtime_error("unsupported input sample rate");
+  }
+
+  auto const gcd = std::gcd(inputRate, OUTPUT_RATE);
+
+  m_up   = OUTPUT_RATE / gcd;
+  m_down = inputRate   / gcd;
+
+  // Prototype filter runs at the interpolated rate; size it per Kaiser's
+  // estimate, rounded up to a whole number of taps per phase.
+
+  auto const rate  = static_cast<double>(inputRate) * m_up;
+  auto const width = 2.0 * std::numbers::pi * (STOP_EDGE - PASS_EDGE) / rate;
+  auto const beta  = 0.1102 * (ATTENUATION - 8.7);
+  auto const count = static_cast<std::size_t>(std::ceil((ATTENUATION - 7.95) / (2.285 * width))) + 1;
+
+  m_taps = (count + m_up - 1) / m_up;
+
+  auto const size   = m_taps * m_up;
+  auto const center = (size - 1) / 2.0;
+  auto const cutoff = (PASS_EDGE + STOP_EDGE) / 2.0 / rate;
+  auto const scale  = bessel(beta);
+
+  std::vector<double> prototype(size);
+
+  for (std::size_t n = 0; n < size; ++n)
+  {
+    auto const x    = n - center;
+    auto const r    = x / (center + 0.5);
+    auto const sinc = x == 0.0 ? 1.0 : std::sin(2.0 * std::numbers::pi * cutoff * x)
+                                     / (2.0 * std::numbers::pi * cutoff * x);
+
+    prototype[n] = 2.0 * cutoff * sinc * bessel(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / scale;
+  }
+
+  // Normalize for unity gain at DC in each phase, i.e., a gain of L for
+  // the prototype, making up for the zeros interpolation would insert.
+
+  auto const gain = m_up / std::accumulate(prototype.begin(), prototype.end(), 0.0);
+
+  // Decompose into phases; phase p takes every Lth tap starting from p,
+  // reversed so as to line up with the delay line, oldest sample first.
+
+  m_phases.resize(size);
+
+  for (std::size_t p = 0; p < m_up; ++p)
+  {
+    for (std::size_t k = 0; k < m_taps; ++k)
+    {
+      m_phases[p * m_taps + (m_taps - 1 - k)] = static_cast<float>(prototype[p + k * m_up] * gain);
+    }
+  }
+
+  m_delay.resize(2 * m_taps);
+}
+
+void
+Decimator::reset()
+{
+  std::fill(m_delay.begin(), m_delay.end(), 0.0f);
+
+  m_write = 0;
+  m_phase = 0;
+}
+
+/******************************************************************************/
@@ -0,0 +1,94 @@
+#ifndef DECIMATOR_HPP__
+#define DECIMATOR_HPP__
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <vendor/Eigen/Dense>
+
+// Polyphase rational resampler, by which we reduce audio captured at the
+// input rate to the 12kHz rate used by the decoder. The ratio of output
+// to input rates, in lowest terms, is L / M; the lowpass FIR runs, in
+// principle, at L times the input rate, but is decomposed into L phases,
+// of which each output requires only one. For the integer rates, e.g.,
+// 48kHz, 96kHz, and 192kHz, L is 1, and the single phase is run on every
+// Mth input; 44.1kHz is 40 / 147.
+//
+// History is held in a circular delay line that's stored twice over, so
+// that the most recent window of input is always contiguous; each output
+// is then a single vectorized dot product, and nothing is shifted as new
+// samples arrive. Output is floating point, so no precision is lost to
+// rounding on the way to the decoder.
+
+class Decimator final
+{
+public:
+
+  // Rate to which we decimate.
+
+  static constexpr unsigned OUTPUT_RATE = 12000;
+
+  // Determine if we're able to decimate from the input rate provided.
+
+  static bool supports(unsigned inputRate);
+
+  // Constructor; throws if the input rate isn't supported.
+
+  explicit Decimator(unsigned inputRate);
+
+  // Accessors
+
+  unsigned inputRate() const { return m_inputRate; }
+  double   ratio()     const { return static_cast<double>(m_down) / m_up; }
+
+  // Discard history, as for a discontinuity in the input.
+
+  void reset();
+
+  // Run input samples through the filter, invoking the sink provided on
+  // each output sample as it's produced.
+
+  template <typename Sink>
+  void
+  process(std::int16_t const * const input,
+          std::size_t          const count,
+          Sink                    && sink)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto const sample = static_cast<float>(input[i]);
+
+      m_delay[m_write]          = sample;
+      m_delay[m_write + m_taps] = sample;
+
+      if (++m_write == m_taps) m_write = 0;
+
+      // The window is now the most recent m_taps inputs, oldest first;
+      // produce each output that falls between this input and the next.
+
+      for (; m_phase < m_up; m_phase += m_down)
+      {
+        sink(Vector(m_phases.data() + m_phase * m_taps, m_taps)
+            .dot(Vector(m_delay.data() + m_write, m_taps)));
+      }
+
+      m_phase -= m_up;
+    }
+  }
+
+private:
+
+  using Vector = Eigen::Map<Eigen::VectorXf const>;
+
+  // Data members
+
+  unsigned           m_inputRate;
+  std::size_t        m_up;
+  std::size_t        m_down;
+  std::size_t        m_taps;       // per phase
+  std::vector<float> m_phases;     // L phases of m_taps, each reversed
+  std::vector<float> m_delay;      // 2 * m_taps
+  std::size_t        m_write = 0;
+  std::size_t        m_phase = 0;
+};
+
+#endif
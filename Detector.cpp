@@ -1,46 +1,14 @@
 #include "Detector.hpp"
 #include <algorithm>
 #include <cmath>
+#include <utility>
 #include <QDateTime>
 #include <QLoggingCategory>
 #include <QMutexLocker>
 #include <QtAlgorithms>
 #include "commons.h"
 #include "DriftingDateTime.h"
-
-/******************************************************************************/
-// FIR Filter Coefficients
-/******************************************************************************/
-
-namespace
-{
-  // Filter coefficients for an FIR lowpass filter designed using ScopeFIR.
-  //
-  //   fsample     = 48000 Hz
-  //   Ntaps       = 49
-  //   fc          = 4500  Hz
-  //   fstop       = 6000  Hz
-  //   Ripple      = 1     dB
-  //   Stop Atten  = 40    dB
-  //   fout        = 12000 Hz
-
-  constexpr std::array LOWPASS
-  {
-     0.000861074040f,  0.010051920210f,  0.010161983649f,  0.011363155076f,
-     0.008706594219f,  0.002613872664f, -0.005202883094f, -0.011720748164f,
-    -0.013752163325f, -0.009431602741f,  0.000539063909f,  0.012636767098f,
-     0.021494659597f,  0.021951235065f,  0.011564169382f, -0.007656470131f,
-    -0.028965787341f, -0.042637874109f, -0.039203309748f, -0.013153301537f,
-     0.034320769178f,  0.094717832646f,  0.154224604789f,  0.197758325022f,
-     0.213715139513f,  0.197758325022f,  0.154224604789f,  0.094717832646f,
-     0.034320769178f, -0.013153301537f, -0.039203309748f, -0.042637874109f,
-    -0.028965787341f, -0.007656470131f,  0.011564169382f,  0.021951235065f,
-     0.021494659597f,  0.012636767098f,  0.000539063909f, -0.009431602741f,
-    -0.013752163325f, -0.011720748164f, -0.005202883094f,  0.002613872664f,
-     0.008706594219f,  0.011363155076f,  0.010161983649f,  0.010051920210f,
-     0.000861074040f
-  };
-}
+#include "JS8Snapshot.hpp"
 
 /******************************************************************************/
 // Implementation
@@ -50,21 +18,65 @@ namespace
 
 Q_DECLARE_LOGGING_CATEGORY(detector_js8)
 
-Detector::Detector(unsigned  frameRate,
-                   unsigned  periodLengthInSeconds,
-                   QObject * parent)
+namespace
+{
+  // Time for which our thread will wait on audio before deciding that
+  // it's stopped arriving; far longer than any audio buffer.
+
+  constexpr int STARVED_MS = 500;
+}
+
+Detector::Detector(JS8::Capture & capture,
+                   unsigned       frameRate,
+                   unsigned       periodLengthInSeconds,
+                   QObject      * parent)
   : AudioDevice (parent)
+  , m_capture   (capture)
   , m_frameRate (frameRate)
   , m_period    (periodLengthInSeconds)
-  , m_filter    (LOWPASS)
+  , m_ring      (std::make_unique<Ring>())
+  , m_decimator (m_sampleRate)
 {
   clear();
+
+  m_thread.reset(QThread::create([this] { run(); }));
+  m_thread->start(QThread::HighPriority);
+}
+
+Detector::~Detector()
+{
+  m_quit = true;
+  m_ready.release();
+  m_thread->wait();
 }
 
 void
 Detector::setBlockSize (unsigned n)
 {
-  m_samplesPerFFT = n;
+  m_samplesPerFFT = qMin(static_cast<std::size_t>(n), MaxBufferSize);
+}
+
+// Capture may run at any rate that we're able to decimate from; if the
+// rate changes, our thread must redesign the filter for it.
+
+void
+Detector::setSampleRate(unsigned const rate)
+{
+  if (Decimator::supports(rate)) m_sampleRate = rate;
+
+  if (auto const secondary = m_secondary.load()) secondary->setSampleRate(rate);
+}
+
+// With stereo input, the channel that we're not using can be fed to the
+// secondary receiver; it's de-interleaved by us, and pushed directly into
+// its ring, so a single capture stream serves both.
+
+void
+Detector::setSecondary(Detector * const secondary)
+{
+  if (secondary) secondary->setSampleRate(m_sampleRate);
+
+  m_secondary = secondary;
 }
 
 bool
@@ -83,8 +95,9 @@ Detector::clear()
   resetBufferPosition();
   resetBufferContent();
 #else
-  dec_data.params.kin = 0;
-  m_bufferPos = 0;
+  m_capture.params.kin     = 0;
+  m_capture.params.origin += JS8_RX_SAMPLE_SIZE;
+  m_discard = true;
 #endif
 
   // fill buffer with zeros (G4WJS commented out because it might cause decoder hangs)
@@ -99,29 +112,21 @@ Detector::resetBufferPosition()
   // set index to roughly where we are in time (1ms resolution)
   qint64   const now        = DriftingDateTime::currentMSecsSinceEpoch ();
   unsigned const msInPeriod = (now % 86400000LL) % (m_period * 1000);
-  int      const prevKin    = dec_data.params.kin;
+  int      const prevKin    = m_capture.params.kin;
 
-  dec_data.params.kin = qMin ((msInPeriod * m_frameRate) / 1000, static_cast<unsigned> (sizeof (dec_data.d2) / sizeof (dec_data.d2[0])));
-  m_bufferPos         = 0;
+  m_capture.params.kin = qMin ((msInPeriod * m_frameRate) / 1000, static_cast<unsigned> (sizeof (m_capture.d2) / sizeof (m_capture.d2[0])));
+  m_discard           = true;
   m_ns                = secondInPeriod();
 
-  int const delta = dec_data.params.kin - prevKin;
+  int const delta = m_capture.params.kin - prevKin;
 
-  qCDebug(detector_js8) << "advancing detector buffer from" << prevKin << "to" << dec_data.params.kin << "delta" << delta;
+  qCDebug(detector_js8) << "advancing detector buffer from" << prevKin << "to" << m_capture.params.kin << "delta" << delta;
 
-  // rotate buffer moving the contents that were at prevKin to the new kin position
-  if (delta < 0)
-  {
-    std::rotate(std::begin(dec_data.d2),
-                std::begin(dec_data.d2) - delta,
-                std::end  (dec_data.d2));
-  }
-  else
-  {
-    std::rotate(std::rbegin(dec_data.d2),
-                std::rbegin(dec_data.d2) + delta,
-                std::rend  (dec_data.d2));
-  }
+  // Move the origin such that the contents that were at prevKin are now
+  // at the new kin position; nothing in the buffer moves, so any spans
+  // pinned by the decoder, and anything it knows about them, remain valid.
+
+  m_capture.params.origin -= delta;
 }
 
 void
@@ -129,73 +134,166 @@ Detector::resetBufferContent()
 {
   QMutexLocker mutex(&m_lock);
 
-  std::fill(std::begin(dec_data.d2), std::end(dec_data.d2), 0);
+  JS8::detach(m_capture);
+  std::fill(std::begin(m_capture.d2), std::end(m_capture.d2), 0);
+  ++m_capture.params.epoch;
   qCDebug(detector_js8) << "clearing detector buffer content";
 }
 
+// Called on the audio thread; de-interleave the data into the ring, and
+// wake up our thread to deal with it. Data that won't fit in the ring is
+// dropped and counted; we never wait.
+
 qint64
 Detector::writeData(char const * const data,
                     qint64       const maxSize)
 {
-  QMutexLocker mutex(&m_lock);
+  // No torn frames.
+
+  Q_ASSERT (!(maxSize % static_cast<qint64>(bytesPerFrame())));
+
+  size_t const frames = maxSize / bytesPerFrame();
+
+  // Take a channel from the frames into the ring of a receiver, and wake
+  // up its thread.
+
+  auto const push = [&](Detector & receiver,
+                        Channel    channel)
+  {
+    size_t const accepted = receiver.m_ring->push(frames, [&](std::size_t const offset,
+                                                              std::size_t const count,
+                                                              qint16    * const dest)
+    {
+      store(&data[offset * bytesPerFrame()], count, dest, channel);
+    });
+
+    if (accepted < frames) receiver.m_overruns.fetch_add(frames - accepted, std::memory_order_relaxed);
+
+    if (!receiver.m_drainPending.exchange(true)) receiver.m_ready.release();
+  };
 
-  // When ns has wrapped around to zero, restart the buffers.
+  push(*this, channel());
 
-  int const ns = secondInPeriod();
-  if(ns < m_ns) {
-    dec_data.params.kin = 0;
-    m_bufferPos         = 0;
+  if (auto const secondary = m_secondary.load();
+                 secondary && Mono != channel())
+  {
+    push(*secondary, Right == channel() ? Left : Right);
   }
-  m_ns = ns;
 
-  // No torn frames.
+  return maxSize;
+}
 
-  Q_ASSERT (!(maxSize % static_cast<qint64>(bytesPerFrame())));
+// Our thread; drains the ring each time the audio thread writes to it,
+// until we're destroyed.
+
+void
+Detector::run()
+{
+  bool flowing = false;
 
-  // These are in terms of input frames (not down sampled).
+  while (!m_quit)
+  {
+    if (!m_ready.tryAcquire(1, STARVED_MS))
+    {
+      if (std::exchange(flowing, false)) m_underruns.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
 
-  size_t const framesAcceptable = (sizeof(dec_data.d2) / sizeof(dec_data.d2[0]) - dec_data.params.kin) * Filter::NDOWN;
-  size_t const framesAccepted   = qMin(static_cast<size_t>(maxSize /bytesPerFrame()), framesAcceptable);
+    m_drainPending = false;
 
-  if (framesAccepted < static_cast<size_t>(maxSize / bytesPerFrame()))
+    if (drain()) flowing = true;
+  }
+}
+
+// Decimate whatever's in the ring; whenever we've accumulated a block's
+// worth of output, hand it off to the capture buffer.
+
+std::size_t
+Detector::drain()
+{
+  if (auto const rate = m_sampleRate.load(); rate != m_decimator.inputRate())
   {
-    qCDebug(detector_js8) << "dropped " << maxSize / bytesPerFrame () - framesAccepted
-              << " frames of data on the floor!"
-              << dec_data.params.kin
-              << ns;
+    qCDebug(detector_js8) << "decimating from" << rate << "Hz";
+
+    m_decimator = Decimator(rate);
+    m_outputPos = 0;
   }
 
-  for (auto remaining = framesAccepted;
-                remaining;)
+  if (m_discard.exchange(false)) m_outputPos = 0;
+
+  int const   ns = secondInPeriod();
+  int         kin;
+  std::size_t framesAcceptable;
   {
-    size_t const numFramesProcessed = qMin(m_samplesPerFFT * Filter::NDOWN - m_bufferPos, remaining);
+    QMutexLocker mutex(&m_lock);
 
-    store (&data[(framesAccepted - remaining) * bytesPerFrame()],
-           numFramesProcessed,
-           &m_buffer[m_bufferPos]);
+    // When ns has wrapped around to zero, restart the buffers; the
+    // origin advances a full buffer, so that positions from the last
+    // period map to the same indices, and the write head only advances.
 
-    m_bufferPos += numFramesProcessed;
+    if(ns < m_ns) {
+      m_capture.params.kin     = 0;
+      m_capture.params.origin += JS8_RX_SAMPLE_SIZE;
+      m_outputPos             = 0;
+    }
+    m_ns = ns;
+
+    // These are in terms of input frames (not down sampled).
+
+    kin              = m_capture.params.kin;
+    framesAcceptable = static_cast<size_t>((sizeof(m_capture.d2) / sizeof(m_capture.d2[0]) - kin) * m_decimator.ratio());
+  }
+
+  return m_ring->drain([&](qint16 const * const samples,
+                           std::size_t    const count)
+  {
+    size_t const framesAccepted = qMin(count, framesAcceptable);
 
-    if (m_bufferPos == m_samplesPerFFT * Filter::NDOWN)
+    // We drop any data past the end of the buffer on the floor
+    // until the next period starts
+
+    if (framesAccepted < count)
     {
-      if (dec_data.params.kin >= 0 &&
-          dec_data.params.kin < static_cast<int>(JS8_NTMAX * 12000 - m_samplesPerFFT))
-      {
-        for (std::size_t i = 0; i < m_samplesPerFFT; ++i)
-        {
-          dec_data.d2[dec_data.params.kin++] = m_filter.downSample(&m_buffer[i * Filter::NDOWN]);
-        }
-      }
-      Q_EMIT framesWritten (dec_data.params.kin);
-      m_bufferPos = 0;
+      qCDebug(detector_js8) << "dropped " << count - framesAccepted
+                << " frames of data on the floor!"
+                << kin
+                << ns;
     }
-    remaining -= numFramesProcessed;
-  }
 
-  // We drop any data past the end of the buffer on the floor
-  // until the next period starts
+    framesAcceptable -= framesAccepted;
 
-  return maxSize;
+    m_decimator.process(samples, framesAccepted, [this](float const sample)
+    {
+      m_output[m_outputPos++] = sample;
+
+      if (m_outputPos >= m_samplesPerFFT) flush();
+    });
+  });
+}
+
+// Write a block of output to the capture buffer; this, and checking for
+// the start of a period, are all that we do while holding the mutex. If
+// the buffer's been reset since we started on the block, it's discarded.
+
+void
+Detector::flush()
+{
+  qint64 kin;
+  {
+    QMutexLocker mutex(&m_lock);
+
+    if (!m_discard.exchange(false) &&
+        m_capture.params.kin >= 0   &&
+        m_capture.params.kin <  static_cast<int>(JS8_NTMAX * 12000 - m_outputPos))
+    {
+      JS8::write(m_capture, m_capture.params.kin, m_output.data(), static_cast<int>(m_outputPos));
+
+      m_capture.params.kin += static_cast<int>(m_outputPos);
+    }
+    kin = m_capture.params.kin;
+  }
+  Q_EMIT framesWritten (kin);
+  m_outputPos = 0;
 }
 
 unsigned
@@ -1,91 +1,125 @@
 #ifndef DETECTOR_HPP__
 #define DETECTOR_HPP__
 #include "AudioDevice.hpp"
+#include "Decimator.hpp"
+#include "JS8Snapshot.hpp"
+#include <algorithm>
 #include <array>
-#include <vendor/Eigen/Dense>
+#include <atomic>
+#include <bit>
+#include <memory>
 #include <QMutex>
+#include <QSemaphore>
+#include <QThread>
 
 // Output device that distributes data in predefined chunks via a signal;
-// underlying device for this abstraction is just the buffer that stores
-// samples throughout a receiving period.
+// underlying device for this abstraction is just the capture buffer that
+// stores samples throughout a receiving period.
+//
+// Data written to us arrives on the audio thread, which must never wait;
+// it's de-interleaved into a lock-free ring, and handed off to a thread
+// of our own that decimates it and writes it to the buffer, taking the
+// mutex only while doing so.
 
 class Detector : public AudioDevice
 {
   Q_OBJECT;
 
-  // We downsample the input data from 48kHz to 12kHz through this
-  // lowpass FIR filter.
+  // Fixed-capacity, wait-free, single producer, single consumer ring of
+  // de-interleaved input samples, by which the audio thread hands data
+  // off to our thread. Room for a few seconds at the highest rates.
 
-  class Filter final
+  class Ring final
   {
   public:
 
-    // Amount we're going to downsample; a factor of 4, i.e., 48kHz to
-    // 12kHz, and number of taps in the FIR lowpass filter we're going
-    // to use for the downsample process. These together result in the
-    // amount to shift data in the FIR filter each time we input a new
-    // sample.
+    static constexpr std::size_t CAPACITY = 1 << 20;
 
-    static constexpr std::size_t NDOWN = 48 / 12;
-    static constexpr std::size_t NTAPS = 49;
-    static constexpr std::size_t SHIFT = NTAPS - NDOWN;
+    static_assert(std::has_single_bit(CAPACITY));
 
-    // Our FIR is constructed of a pair of Eigen vectors, each NTAPS in
-    // size. Loading in a sample consists of mapping it to a read-only
-    // view of an Eigen vector, NDOWN in size.
+    // Producer side; stores as many of the count of samples requested as
+    // there's room for, by way of the function provided, which is invoked
+    // with the offset, size, and destination of each contiguous segment.
+    // Returns the number stored.
 
-    using Vector =            Eigen::Vector<float, NTAPS>;
-    using Sample = Eigen::Map<Eigen::Vector<short, NDOWN> const>;
+    template <typename Function>
+    std::size_t
+    push(std::size_t const   count,
+         Function         && function)
+    {
+      auto const tail     = m_tail.load(std::memory_order_relaxed);
+      auto const accepted = std::min(count, CAPACITY - (tail - m_head.load(std::memory_order_acquire)));
+      auto const index    = tail & (CAPACITY - 1);
+      auto const first    = std::min(accepted, CAPACITY - index);
+
+      if (first)            function(0,     first,            &m_samples[index]);
+      if (first < accepted) function(first, accepted - first, &m_samples[0]);
 
-    // Constructor; we require an array of lowpass FIR coefficients,
-    // equal in size to the number of taps.
+      m_tail.store(tail + accepted);
 
-    explicit Filter(std::array<Vector::value_type, NTAPS> const & lowpass)
-    : m_w(lowpass.data())
-    , m_t(Vector::Zero())
-    {}
+      return accepted;
+    }
 
-    // Shift existing data in the lowpass FIR to make room for a new
-    // sample and load it in; downsample through the filter.
+    // Consumer side; invokes the function provided on each contiguous
+    // segment of samples currently in the ring, in order, returning the
+    // number consumed.
 
-    auto
-    downSample(Sample::value_type const * const data)
+    template <typename Function>
+    std::size_t
+    drain(Function && function)
     {
-      m_t.head(SHIFT) = m_t.segment(NDOWN, SHIFT);
-      m_t.tail(NDOWN) = Sample(data).cast<Vector::value_type>();
+      auto const head  = m_head.load(std::memory_order_relaxed);
+      auto const tail  = m_tail.load();
+      auto const count = tail - head;
+      auto const index = head & (CAPACITY - 1);
+      auto const first = std::min(count, CAPACITY - index);
+
+      if (first)         function(&m_samples[index], first);
+      if (first < count) function(&m_samples[0],     count - first);
+
+      m_head.store(tail, std::memory_order_release);
 
-      return static_cast<Sample::value_type>(std::round(m_w.dot(m_t)));
+      return count;
     }
 
   private:
 
-    // Data members
-
-    Eigen::Map<Vector const> m_w;
-    Vector                   m_t;
+    std::array<qint16, CAPACITY>         m_samples;
+    alignas(64) std::atomic<std::size_t> m_head = 0;
+    alignas(64) std::atomic<std::size_t> m_tail = 0;
   };
 
   // Size of a maximally-sized buffer.
 
   static constexpr std::size_t MaxBufferSize = 7 * 512;
 
-  // A De-interleaved sample buffer big enough for all the
-  // samples for one increment of data (a signals worth) at
-  // the input sample rate.
+  // The decimated output of one increment of data (a signal's worth)
+  // at the output sample rate.
 
-  using Buffer = std::array<short, MaxBufferSize * Filter::NDOWN>;
+  using Output = std::array<float, MaxBufferSize>;
 
 public:
 
-  // Constructor
+  // Constructor and destructor
 
-  Detector(unsigned  frameRate,
-           unsigned  periodLengthInSeconds,
-           QObject * parent = nullptr);
+  Detector(JS8::Capture & capture,
+           unsigned       frameRate,
+           unsigned       periodLengthInSeconds,
+           QObject      * parent = nullptr);
+  ~Detector() override;
 
   // Inline accessors
 
-  unsigned period() const { return m_period; }
+  unsigned   period()    const { return m_period;           }
+  Detector * secondary() const { return m_secondary.load(); }
+
+  // Input frames dropped because the ring was full, i.e., because our
+  // thread fell behind the audio thread, and the number of times that
+  // audio stopped arriving while our thread was waiting on it, which
+  // includes the input stream being suspended; both since construction.
+
+  std::size_t overruns()  const { return m_overruns .load(std::memory_order_relaxed); }
+  std::size_t underruns() const { return m_underruns.load(std::memory_order_relaxed); }
 
   // Inline manipulators
 
@@ -102,6 +136,8 @@ public:
   bool reset() override;
   void resetBufferContent();
   void resetBufferPosition();
+  void setSampleRate(unsigned) override;
+  void setSecondary(Detector *);
 
   // Signals and slots
 
@@ -117,16 +153,34 @@ protected:
 
 private:
 
-  // Data members
-
-  unsigned          m_frameRate;
-  unsigned          m_period;
-  QMutex            m_lock;
-  Filter            m_filter;
-  Buffer            m_buffer;
-  Buffer::size_type m_bufferPos     = 0;
-  std::size_t       m_samplesPerFFT = MaxBufferSize;
-  qint32            m_ns            = 999;
+  // Run on our thread.
+
+  void        run();
+  std::size_t drain();
+  void        flush();
+
+  // Data members; those following the ring belong to our thread, apart
+  // from the atomics, by which other threads make requests of it.
+
+  JS8::Capture             & m_capture;
+  unsigned                   m_frameRate;
+  unsigned                   m_period;
+  QMutex                     m_lock;
+  QSemaphore                 m_ready;
+  std::unique_ptr<Ring>      m_ring;
+  std::atomic<bool>          m_drainPending  = false;
+  std::atomic<Detector *>    m_secondary     = nullptr;
+  std::atomic<std::size_t>   m_overruns      = 0;
+  std::atomic<std::size_t>   m_underruns     = 0;
+  std::atomic<bool>          m_quit          = false;
+  std::atomic<bool>          m_discard       = false;
+  std::atomic<unsigned>      m_sampleRate    = 48000;
+  std::atomic<std::size_t>   m_samplesPerFFT = MaxBufferSize;
+  Decimator                  m_decimator;
+  Output                     m_output;
+  Output::size_type          m_outputPos     = 0;
+  qint32                     m_ns            = 999;
+  std::unique_ptr<QThread>   m_thread;
 };
 
 #endif
@@ -0,0 +1,285 @@
+#include "FFTWPlans.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <QThread>
+#include "commons.h"
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+namespace
+{
+  // Flags used to plan in the background; patient planning would often
+  // be better still, but can take minutes on the larger problems, all
+  // the while holding the FFTW mutex.
+
+  constexpr unsigned MEASURE = FFTW_MEASURE;
+
+  // Problems waiting to be measured, problems we've seen before, and
+  // the state of the background thread, all protected by the queue
+  // mutex. The generation is bumped each time wisdom is added.
+
+  std::mutex                    queueMutex;
+  std::condition_variable       queueCondition;
+  std::deque<FFTW::Problem>     queue;
+  std::set<FFTW::Problem>       known;
+  std::unique_ptr<QThread>      thread;
+  std::string                   wisdomFile;
+  bool                          stopping   = false;
+  std::atomic<unsigned>         generation = 0;
+
+  // Create a plan for the problem, using the provided arrays and flags.
+  // Caller must hold the FFTW mutex.
+
+  fftwf_plan
+  create(FFTW::Problem const & problem,
+         void          * const in,
+         void          * const out,
+         unsigned        const flags)
+  {
+    using Kind = FFTW::Problem::Kind;
+
+    switch (problem.kind)
+    {
+      case Kind::C2C:
+        return fftwf_plan_many_dft(1, &problem.n, problem.howmany,
+                                   static_cast<fftwf_complex *>(in),
+                                   nullptr, 1, problem.idist,
+                                   static_cast<fftwf_complex *>(out),
+                                   nullptr, 1, problem.odist,
+                                   problem.sign,
+                                   flags);
+      case Kind::R2C:
+        return fftwf_plan_many_dft_r2c(1, &problem.n, problem.howmany,
+                                       static_cast<float *>(in),
+                                       nullptr, 1, problem.idist,
+                                       static_cast<fftwf_complex *>(out),
+                                       nullptr, 1, problem.odist,
+                                       flags);
+    }
+
+    return nullptr;
+  }
+
+  // Note a problem for measurement, if we've not seen it before.
+
+  void
+  request(FFTW::Problem const & problem)
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+
+    if (known.insert(problem).second)
+    {
+      queue.push_back(problem);
+      queueCondition.notify_one();
+    }
+  }
+
+  // Measure a problem on arrays of our own, which need only be of the
+  // same size, alignment, and placement as the ones the plan will be
+  // used on, record the wisdom learned, and persist it.
+
+  void
+  measure(FFTW::Problem const & problem)
+  {
+    using Kind = FFTW::Problem::Kind;
+
+    auto const batch = [&](int const dist, std::size_t const size)
+    {
+      return static_cast<std::size_t>(problem.howmany - 1) * dist + size;
+    };
+
+    auto const inBytes  = problem.kind == Kind::C2C
+                        ? batch(problem.idist, problem.n) * sizeof(fftwf_complex)
+                        : batch(problem.idist, problem.n) * sizeof(float);
+    auto const outBytes = problem.kind == Kind::C2C
+                        ? batch(problem.odist, problem.n)         * sizeof(fftwf_complex)
+                        : batch(problem.odist, problem.n / 2 + 1) * sizeof(fftwf_complex);
+
+    void * const in  = fftwf_malloc(problem.inPlace ? std::max(inBytes, outBytes) : inBytes);
+    void * const out = problem.inPlace ? in : fftwf_malloc(outBytes);
+
+    if (in && out)
+    {
+      std::lock_guard<std::mutex> lock(fftw_mutex);
+
+      if (auto const plan = create(problem, in, out, MEASURE))
+      {
+        fftwf_destroy_plan(plan);
+      }
+
+      if (!wisdomFile.empty()) fftwf_export_wisdom_to_filename(wisdomFile.c_str());
+    }
+
+    if (out != in) fftwf_free(out);
+    fftwf_free(in);
+
+    generation.fetch_add(1, std::memory_order_release);
+  }
+
+  // Runloop for the background thread; measure problems as they arrive,
+  // until asked to stop.
+
+  void
+  run()
+  {
+    while (true)
+    {
+      FFTW::Problem problem;
+      {
+        std::unique_lock<std::mutex> lock(queueMutex);
+
+        queueCondition.wait(lock, [] { return stopping || !queue.empty(); });
+
+        if (stopping) return;
+
+        problem = queue.front();
+        queue.pop_front();
+      }
+
+      measure(problem);
+    }
+  }
+}
+
+/******************************************************************************/
+// Public Interface
+/******************************************************************************/
+
+namespace FFTW
+{
+  Plan::Plan(Problem const & problem,
+             void          * in,
+             void          * out)
+  : m_problem   (problem)
+  , m_in        (in)
+  , m_out       (out)
+  , m_generation(generation.load(std::memory_order_acquire))
+  {
+    {
+      std::lock_guard<std::mutex> lock(fftw_mutex);
+
+      if ((m_plan = create(m_problem, m_in, m_out, MEASURE | FFTW_WISDOM_ONLY)))
+      {
+        m_measured = true;
+        return;
+      }
+
+      m_plan = create(m_problem, m_in, m_out, FFTW_ESTIMATE_PATIENT);
+    }
+
+    if (m_plan) request(m_problem);
+  }
+
+  Plan::~Plan()
+  {
+    if (m_plan)
+    {
+      std::lock_guard<std::mutex> lock(fftw_mutex);
+      fftwf_destroy_plan(m_plan);
+    }
+  }
+
+  Plan::Plan(Plan && other) noexcept
+  : m_problem   (other.m_problem)
+  , m_in        (other.m_in)
+  , m_out       (other.m_out)
+  , m_plan      (std::exchange(other.m_plan, nullptr))
+  , m_generation(other.m_generation)
+  , m_measured  (other.m_measured)
+  {}
+
+  Plan &
+  Plan::operator=(Plan && other) noexcept
+  {
+    if (this != &other)
+    {
+      Plan old(std::move(*this));
+
+      m_problem    = other.m_problem;
+      m_in         = other.m_in;
+      m_out        = other.m_out;
+      m_plan       = std::exchange(other.m_plan, nullptr);
+      m_generation = other.m_generation;
+      m_measured   = other.m_measured;
+    }
+
+    return *this;
+  }
+
+  void
+  Plan::refresh()
+  {
+    if (!m_plan || m_measured) return;
+
+    auto const current = generation.load(std::memory_order_acquire);
+
+    if (current == m_generation) return;
+
+    // The planner is very likely busy measuring the next problem, which
+    // can take seconds; rather than waiting on it, we'll try again the
+    // next time we're called, having left our generation as it was.
+
+    std::unique_lock<std::mutex> lock(fftw_mutex, std::try_to_lock);
+
+    if (!lock) return;
+
+    m_generation = current;
+
+    if (auto const plan = create(m_problem, m_in, m_out, MEASURE | FFTW_WISDOM_ONLY))
+    {
+      fftwf_destroy_plan(m_plan);
+      m_plan     = plan;
+      m_measured = true;
+    }
+  }
+
+  void
+  start(char const * const file)
+  {
+    {
+      std::lock_guard<std::mutex> lock(fftw_mutex);
+      fftwf_import_wisdom_from_filename(file);
+    }
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+
+    if (thread) return;
+
+    wisdomFile = file;
+    stopping   = false;
+    thread.reset(QThread::create(run));
+    thread->start(QThread::LowestPriority);
+  }
+
+  void
+  stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+
+      if (!thread) return;
+
+      stopping = true;
+      queueCondition.notify_one();
+    }
+
+    thread->wait();
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    std::lock_guard<std::mutex> fftwLock(fftw_mutex);
+
+    fftwf_export_wisdom_to_filename(wisdomFile.c_str());
+
+    thread.reset();
+  }
+}
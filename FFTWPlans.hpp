@@ -0,0 +1,100 @@
+#ifndef FFTW_PLANS_HPP_
+#define FFTW_PLANS_HPP_
+
+#include <compare>
+#include <fftw3.h>
+
+namespace FFTW
+{
+  // Description of a one-dimensional transform, or a batch of them, in
+  // terms sufficient to plan it on arrays other than the ones on which
+  // it'll be executed. Distances between transforms in a batch are in
+  // terms of the element type, i.e., float for real data, and complex
+  // for complex data; they're ignored for a batch of one.
+
+  struct Problem
+  {
+    enum class Kind
+    {
+      C2C,
+      R2C
+    };
+
+    Kind kind    = Kind::C2C;
+    int  n       = 0;
+    int  sign    = FFTW_FORWARD;
+    int  howmany = 1;
+    int  idist   = 0;
+    int  odist   = 0;
+    bool inPlace = true;
+
+    auto operator<=>(Problem const &) const = default;
+  };
+
+  // A plan for a problem on a specific set of arrays, obtained from the
+  // planning service. If measured wisdom for the problem is on hand, the
+  // plan is created from it; otherwise, we start with an estimated plan,
+  // and the service measures the problem on a low-priority thread of its
+  // own. Once it's done so, refresh() will swap in a plan created from
+  // the measured wisdom.
+  //
+  // Planning never modifies the arrays, so plans may be created for, or
+  // refreshed on, arrays that contain data. Refreshing a plan must not
+  // be concurrent with its execution.
+
+  class Plan
+  {
+  public:
+
+    // Constructors and destructor; a default-constructed plan is empty.
+
+    Plan() = default;
+    Plan(Problem const & problem,
+         void          * in,
+         void          * out);
+
+    ~Plan();
+
+    // Movable, but not copyable.
+
+    Plan            (Plan &&) noexcept;
+    Plan & operator=(Plan &&) noexcept;
+
+    Plan            (Plan const &) = delete;
+    Plan & operator=(Plan const &) = delete;
+
+    // Swap in a plan created from measured wisdom, if any has become
+    // available since we were created. Cheap if nothing has changed, and
+    // never waits on a measurement in progress; if the planner is busy,
+    // the swap is deferred to a later call.
+
+    void refresh();
+
+    // Accessors
+
+    bool measured() const noexcept { return m_measured; }
+
+    explicit operator bool      () const noexcept { return m_plan != nullptr; }
+             operator fftwf_plan() const noexcept { return m_plan;            }
+
+  private:
+
+    Problem    m_problem;
+    void     * m_in         = nullptr;
+    void     * m_out        = nullptr;
+    fftwf_plan m_plan       = nullptr;
+    unsigned   m_generation = 0;
+    bool       m_measured   = false;
+  };
+
+  // Service lifetime; start() imports wisdom from the provided file and
+  // starts measuring problems in the background, exporting wisdom to the
+  // file each time it's learned something. stop() stops measurement and
+  // performs a final export. Plans may be created whether or not the
+  // service is running; problems are measured only while it is.
+
+  void start(char const * wisdomFile);
+  void stop();
+}
+
+#endif
@@ -3,11 +3,17 @@
  **/
 
 #include "JS8.hpp"
+#include "JS8Snapshot.hpp"
+#include "JS8Submode.hpp"
+#include "FFTWPlans.hpp"
 #include <algorithm>
 #include <atomic>
+#include <bit>
+#include <chrono>
 #include <cmath>
 #include <complex>
 #include <concepts>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
@@ -16,17 +22,18 @@
 #include <mutex>
 #include <numbers>
 #include <numeric>
+#include <optional>
+#include <random>
+#include <span>
 #include <stdexcept>
 #include <string_view>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 #include <boost/crc.hpp>
 #include <boost/math/ccmath/round.hpp>
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/key.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/ranked_index.hpp>
 #include <fftw3.h>
 #include <vendor/Eigen/Dense>
 #include <QDebug>
@@ -182,6 +189,7 @@ namespace
     constexpr int         NFSRCH   = 5;        // Search frequency range in Hz (i.e., +/- 2.5 Hz)
     constexpr std::size_t NMAXCAND = 300;      // Maxiumum number of candidate signals
     constexpr int         NFILT    = 1400;  // Filter length
+    constexpr int         NSUB     = 8192;  // Subtraction filter block length
     constexpr int         NROWS    = 8;
     constexpr int         NFOS     = 2;
     constexpr int         NSSY     = 4;
@@ -381,6 +389,36 @@ namespace
     constexpr auto BASELINE_MIN  = 500;
     constexpr auto BASELINE_MAX = 2500;
 
+    // Number of candidates in a decoding pass at which we'll demodulate
+    // them speculatively in parallel; for fewer, the cost of handing them
+    // off to other threads isn't likely to be repaid.
+
+    constexpr std::size_t SPECULATIVE_MIN = 8;
+
+    // Number of symbol spectra that syncjs8() computes with each execution
+    // of its batched FFT plan; large enough to amortize plan overhead, and
+    // small enough that the batch stays resident in cache.
+
+    constexpr int SPECTRA_BATCH = 16;
+
+    // Maximum number of candidates that a demodulation thread downsamples
+    // with each execution of the batched inverse FFT plan.
+
+    constexpr std::size_t DOWNSAMPLE_BATCH = 8;
+
+    // Effort control. A submode decode must be complete before the next one
+    // of that submode is due, so it's allowed this portion of its period.
+    // A decode that's at risk of missing its deadline first limits belief
+    // propagation to fewer of the LLR variants, then drops its lowest-
+    // priority candidates, and skips further passes if there's no time
+    // for another sync. Costs are estimated from past runs, as moving
+    // averages giving this weight to the latest.
+
+    constexpr double DEADLINE_FRACTION  = 0.8;
+    constexpr int    FULL_LLR_PASSES    = 4;
+    constexpr int    REDUCED_LLR_PASSES = 2;
+    constexpr double COST_WEIGHT        = 0.25;
+
     // We're going to do a pairwise Estrin's evaluation of the polynomial
     // coefficients, so it's critical that the degree of the polynomial is
     // odd, resulting in an even number of coefficients.
@@ -489,7 +527,9 @@ namespace
         operator T() const { return m_sum; }
     };
 
-    // Management of dynamic FFTW plan storage.
+    // Management of dynamic FFTW plan storage; plans are obtained from
+    // the planning service, and may be refreshed with better ones as the
+    // service learns more about the problems they solve.
 
     class FFTWPlanManager
     {
@@ -498,6 +538,7 @@ namespace
         enum class Type
         {
             DS,
+            DB,
             BB,
             CF,
             CB,
@@ -515,26 +556,11 @@ namespace
 
         // Constructor
 
-        FFTWPlanManager()
-        {
-            m_plans.fill(nullptr);
-        }
-
-        // Destructor
-
-        ~FFTWPlanManager()
-        {
-            std::lock_guard<std::mutex> lock(fftw_mutex);
-
-            for (auto & plan : m_plans)
-            {
-                if (plan) fftwf_destroy_plan(plan);
-            }
-        }
+        FFTWPlanManager() = default;
 
         // Accessor
 
-        fftwf_plan const &
+        FFTW::Plan const &
         operator[](Type const type) const noexcept
         {
             return m_plans[static_cast<std::size_t>(type)];
@@ -542,12 +568,21 @@ namespace
 
         // Manipulator
 
-        fftwf_plan &
+        FFTW::Plan &
         operator[](Type const type) noexcept
         {
             return m_plans[static_cast<std::size_t>(type)];
         }
 
+        // Swap in any better plans that have become available; must not
+        // be called while any of the plans are executing.
+
+        void
+        refresh()
+        {
+            for (auto & plan : m_plans) plan.refresh();
+        }
+
         // Iteration support
 
         auto begin()       noexcept { return m_plans.begin(); }
@@ -559,9 +594,13 @@ namespace
 
         // Data members
 
-        std::array<fftwf_plan, static_cast<std::size_t>(Type::count)> m_plans;
+        std::array<FFTW::Plan, static_cast<std::size_t>(Type::count)> m_plans;
     };
 
+    // Decoding parameters, as provided to us by the GUI in dec_data.
+
+    using DecodeParams = decltype(dec_data.params);
+
     // Encapsulates the first-order search results provided by syncjs8().
 
     struct Sync
@@ -581,41 +620,6 @@ namespace
         {}
     };
 
-    // Tag structs so that we can refer to multi index container indices
-    // by a descriptive tag instead of by the index of the index. These
-    // don't need to be anything but a name.
-
-    namespace Tag
-    {
-        struct Freq {};
-        struct Rank {};
-        struct Sync {};
-    }
-
-    // Container indexing Sync objects in useful ways, used by syncjs8().
-
-    namespace MI    = boost::multi_index;
-    using SyncIndex = MI::multi_index_container
-    <
-        Sync,
-        MI::indexed_by
-        <
-            MI::ordered_non_unique<
-                MI::tag<Tag::Freq>,
-                MI::key<&Sync::freq>
-            >,
-            MI::ranked_non_unique<
-                MI::tag<Tag::Rank>,
-                MI::key<&Sync::sync>
-            >,
-            MI::ordered_non_unique<
-                MI::tag<Tag::Sync>,
-                MI::key<&Sync::sync>,
-                std::greater<>
-            >
-        >
-    >;
-
     // Represents a decoded message, i.e., the 3-bit message type
     // and the 12 bytes that result from decoding a message.
 
@@ -731,52 +735,122 @@ namespace
         {5, {27, 48, 58,  93, 136,   0,   0}}, {6, { 6, 54, 82, 100, 130, 167,   0}}, {6, {23, 49, 77, 105, 142, 148, 0}}
     }};
 
+    // Flattened Tanner graph of the code, computed at compile time from the
+    // Nm and Mn tables above. Messages are stored by edge, check-major, in
+    // slots padded to a SIMD-friendly stride; each check's edges are thus
+    // contiguous, and each bit knows the slots of its edges directly, so no
+    // reverse edge search is required during iteration. Unused slots refer
+    // to bit N, a sentinel that doesn't participate in decoding.
+
+    constexpr int BP_STRIDE = 8;              // Slots per check; BP_MAX_ROWS, rounded up
+    constexpr int BP_SLOTS  = M * BP_STRIDE;  // Total message slots
+
+    static_assert(BP_STRIDE >= BP_MAX_ROWS);
+
+    struct TannerGraph
+    {
+        std::array<int, BP_SLOTS>                     bits;  // Bit at each slot, N if unused
+        std::array<std::array<int, BP_MAX_CHECKS>, N> edges; // Slots of each bit, in Mn order
+    };
+
+    constexpr auto Graph = []
+    {
+        TannerGraph graph{};
+
+        for (int i = 0; i < M; ++i)
+        {
+            for (int j = 0; j < BP_STRIDE; ++j)
+            {
+                graph.bits[i * BP_STRIDE + j] = j < Nm[i].valid_neighbors
+                                              ? Nm[i].neighbors[j]
+                                              : N;
+            }
+        }
+
+        for (int v = 0; v < N; ++v)
+        {
+            for (int k = 0; k < BP_MAX_CHECKS; ++k)
+            {
+                auto const & check = Nm[Mn[v][k]];
+
+                int j = 0;
+
+                while (j < check.valid_neighbors && check.neighbors[j] != v) ++j;
+
+                if (j == check.valid_neighbors) throw "Inconsistent Nm and Mn tables";
+
+                graph.edges[v][k] = Mn[v][k] * BP_STRIDE + j;
+            }
+        }
+
+        return graph;
+    }();
+
+    // Check node update rules are defined by JS8::BPVariant; the min-sum
+    // variants are trivially vectorized. Offset min-sum subtracts this from
+    // the magnitude of each message.
+
+    using JS8::BPVariant;
+
+    constexpr float BP_OFFSET = 0.3f;
+
     // Belief Propagation Decoder
 
+    template <BPVariant Variant>
     int
     bpdecode174(std::array<float, N> const & llr,
                 std::array<int8_t, K>      & decoded,
-                std::array<int8_t, N>      & cw)
+                std::array<int8_t, N>      & cw,
+                int                        & iterations)
     {
-        // Initialize messages and variables
-        std::array<std::array<float, BP_MAX_CHECKS>, N> tov     = {}; // Messages to variable nodes
-        std::array<std::array<float, BP_MAX_ROWS>,   M> toc     = {}; // Messages to check nodes
-        std::array<std::array<float, BP_MAX_ROWS>  , M> tanhtoc = {}; // Tanh of messages
+        // Messages to check nodes from unused slots must have no effect on
+        // the check node update; for the sum-product rule, we don't look at
+        // them at all, and for min-sum, a large negative value has neither
+        // an effect on sign, nor on the minimum magnitude.
 
-        std::array<float, N> zn   = {}; // Bit log likelihood ratios
-        std::array<int,   M> synd = {}; // Syndrome for checks
+        constexpr float PAD = -std::numeric_limits<float>::max();
+
+        // Initialize messages and variables; bit log likelihood ratios and
+        // hard decisions have an extra element for the sentinel bit.
+
+        alignas(64) std::array<float, BP_SLOTS> tov = {}; // Messages to variable nodes
+        alignas(64) std::array<float, BP_SLOTS> toc;      // Messages to check nodes
+        alignas(64) std::array<float, BP_SLOTS> tanhtoc;  // Tanh of messages
+
+        std::array<float,  N + 1> zn;      // Bit log likelihood ratios
+        std::array<int8_t, N + 1> hard;    // Hard decisions
+
+        zn  [N] = PAD;
+        hard[N] = 0;
 
         int ncnt   = 0;
         int nclast = 0;
 
-        // Initialize toc (messages from bits to checks)
-        for (int i = 0; i < M; ++i) {
-            for (int j = 0; j < Nm[i].valid_neighbors; ++j) {
-                toc[i][j] = llr[Nm[i].neighbors[j]];
-            }
-        }
-
         // Iterative decoding
         for (int iter = 0; iter <= BP_MAX_ITERATIONS; ++iter) {
             // Update bit log likelihood ratios
             for (int i = 0; i < N; ++i) {
-                zn[i] = llr[i] + std::accumulate(tov[i].begin(), tov[i].begin() + BP_MAX_CHECKS, 0.0f);
+                float sum = 0.0f;
+                for (auto const slot : Graph.edges[i]) sum += tov[slot];
+                zn[i] = llr[i] + sum;
             }
 
             // Check if we have a valid codeword
-            for (int i = 0; i < N; ++i) cw[i] = zn[i] > 0 ? 1 : 0;
+            for (int i = 0; i < N; ++i) hard[i] = zn[i] > 0 ? 1 : 0;
 
             int ncheck = 0;
             for (int i = 0; i < M; ++i) {
-                synd[i] = 0;
-                for (int j = 0; j < Nm[i].valid_neighbors; ++j) {
-                    synd[i] += cw[Nm[i].neighbors[j]];
+                int synd = 0;
+                for (int j = 0; j < BP_STRIDE; ++j) {
+                    synd += hard[Graph.bits[i * BP_STRIDE + j]];
                 }
-                if (synd[i] % 2 != 0) ++ncheck;
+                if (synd % 2 != 0) ++ncheck;
             }
 
             if (ncheck == 0)
             {
+                std::copy(hard.begin(), hard.begin() + N, cw.begin());
+
                 // Extract decoded bits (last N-M bits of codeword)
                 std::copy(cw.begin() + M, cw.end(), decoded.begin());
 
@@ -788,6 +862,7 @@ namespace
                     }
                 }
 
+                iterations = iter + 1;
                 return nerr;
             }
 
@@ -796,49 +871,103 @@ namespace
                 int nd = ncheck - nclast;
                 ncnt = (nd < 0) ? 0 : ncnt + 1;
                 if (ncnt >= 5 && iter >= 10 && ncheck > 15) {
+                    std::copy(hard.begin(), hard.begin() + N, cw.begin());
+                    iterations = iter + 1;
                     return -1;
                 }
             }
             nclast = ncheck;
 
-            // Send messages from bits to check nodes
-            for (int i = 0; i < M; ++i) {
-                for (int j = 0; j < Nm[i].valid_neighbors; ++j) {
-                    int ibj = Nm[i].neighbors[j];
-                    toc[i][j] = zn[ibj];
-                    for (int k = 0; k < BP_MAX_CHECKS; ++k) {
-                        if (Mn[ibj][k] == i) {
-                            toc[i][j] -= tov[ibj][k];
-                        }
-                    }
-                }
+            // Send messages from bits to check nodes; the message on an edge
+            // excludes that which the bit received on the same edge.
+            for (int e = 0; e < BP_SLOTS; ++e) {
+                toc[e] = zn[Graph.bits[e]] - tov[e];
             }
 
             // Send messages from check nodes to variable nodes
-            for (int i = 0; i < M; ++i) {
-                for (int j = 0; j < 7; ++j) { // Fixed range [0, 7) to match Fortran's 1:7, could be nrw[j], or 7 logically
-                    tanhtoc[i][j] = std::tanh(-toc[i][j] / 2.0f);
-                }
-            }
+            if constexpr (Variant == BPVariant::SumProduct)
+            {
+                for (int i = 0; i < M; ++i) {
+                    auto const valid = Nm[i].valid_neighbors;
+                    auto const first = i * BP_STRIDE;
 
-            for (int i = 0; i < N; ++i) {
-                for (int j = 0; j < BP_MAX_CHECKS; ++j) {
-                    int ichk = Mn[i][j];
-                    if (ichk >= 0) {
+                    for (int j = 0; j < valid; ++j) {
+                        tanhtoc[first + j] = std::tanh(-toc[first + j] / 2.0f);
+                    }
+
+                    for (int j = 0; j < valid; ++j) {
                         float Tmn = 1.0f;
-                        for (int k = 0; k < Nm[ichk].valid_neighbors; ++k) {
-                            if (Nm[ichk].neighbors[k] != i) {
-                                Tmn *= tanhtoc[ichk][k];
-                            }
+                        for (int k = 0; k < valid; ++k) {
+                            if (k != j) Tmn *= tanhtoc[first + k];
                         }
-                        tov[i][j] = 2.0f * std::atanh(-Tmn);
+                        tov[first + j] = 2.0f * std::atanh(-Tmn);
+                    }
+                }
+            }
+            else
+            {
+                for (int i = 0; i < M; ++i) {
+                    auto const valid = Nm[i].valid_neighbors;
+                    auto const x     = toc.data() + i * BP_STRIDE;
+                    auto const y     = tov.data() + i * BP_STRIDE;
+
+                    // Overall sign, i.e., the product of the signs of the
+                    // negated messages, and the two smallest magnitudes.
+
+                    float sign = 1.0f;
+                    float min1 = std::numeric_limits<float>::max();
+                    float min2 = std::numeric_limits<float>::max();
+
+                    for (int j = 0; j < BP_STRIDE; ++j) {
+                        float const mag = std::abs(x[j]);
+                        sign *= x[j] > 0.0f ? -1.0f : 1.0f;
+                        min2  = std::min(min2, std::max(min1, mag));
+                        min1  = std::min(min1, mag);
+                    }
+
+                    float out1 = min1;
+                    float out2 = min2;
+
+                    if constexpr (Variant == BPVariant::OffsetMinSum) {
+                        out1 = std::max(out1 - BP_OFFSET, 0.0f);
+                        out2 = std::max(out2 - BP_OFFSET, 0.0f);
+                    }
+
+                    // Excluding a message from the sign product is just a
+                    // multiplication by its own sign; excluding it from the
+                    // minimum means using the second smallest magnitude if
+                    // it was the smallest. Unused slots must remain zero.
+
+                    for (int j = 0; j < BP_STRIDE; ++j) {
+                        float const self = x[j] > 0.0f ? -1.0f : 1.0f;
+                        float const mag  = std::abs(x[j]) <= min1 ? out2 : out1;
+                        y[j] = j < valid ? -sign * self * mag : 0.0f;
                     }
                 }
             }
         }
 
+        std::copy(hard.begin(), hard.begin() + N, cw.begin());
+        iterations = BP_MAX_ITERATIONS + 1;
         return -1; // Decoding failed
     }
+
+    // Belief propagation by the rule specified at runtime.
+
+    int
+    bpdecode174(BPVariant            const   variant,
+                std::array<float, N> const & llr,
+                std::array<int8_t, K>      & decoded,
+                std::array<int8_t, N>      & cw,
+                int                        & iterations)
+    {
+        switch (variant)
+        {
+            case BPVariant::MinSum:       return bpdecode174<BPVariant::MinSum>      (llr, decoded, cw, iterations);
+            case BPVariant::OffsetMinSum: return bpdecode174<BPVariant::OffsetMinSum>(llr, decoded, cw, iterations);
+            default:                      return bpdecode174<BPVariant::SumProduct>  (llr, decoded, cw, iterations);
+        }
+    }
 }
 
 /******************************************************************************/
@@ -847,6 +976,39 @@ namespace
 
 namespace
 {
+    // Scoped timer; adds the time elapsed over its lifetime to the provided
+    // duration. Cheap enough to leave enabled on every decode.
+
+    class ScopedTimer
+    {
+        using Clock = std::chrono::steady_clock;
+
+        Clock::duration & m_elapsed;
+        Clock::time_point m_start = Clock::now();
+
+    public:
+
+        explicit ScopedTimer(Clock::duration & elapsed)
+        : m_elapsed(elapsed)
+        {}
+
+        ~ScopedTimer() { m_elapsed += Clock::now() - m_start; }
+
+        ScopedTimer            (ScopedTimer const &) = delete;
+        ScopedTimer & operator=(ScopedTimer const &) = delete;
+    };
+
+    // Update an estimated cost with a new observation of it.
+
+    void
+    estimate(std::chrono::steady_clock::duration       & cost,
+             std::chrono::steady_clock::duration const   sample)
+    {
+        cost = cost == cost.zero()
+             ? sample
+             : cost + std::chrono::duration_cast<std::chrono::steady_clock::duration>((sample - cost) * COST_WEIGHT);
+    }
+
     constexpr std::string_view alphabet = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-+";
 
     static_assert(alphabet.size() == 64);
@@ -1060,6 +1222,167 @@ namespace
                           (index % ElementSize)) & 1;
         };
     }();
+
+    // Hash of a span of samples, used to determine if a cached spectrum of
+    // the samples is still valid. It's computed over independent lanes so
+    // as to be vectorizable; it only needs to be cheap relative to the FFT
+    // that it allows us to avoid.
+
+    std::uint64_t
+    hashSamples(float       const * const data,
+                std::size_t const         size)
+    {
+        constexpr std::size_t LANES = 8;
+
+        std::array<std::uint32_t, LANES> lanes;
+
+        lanes.fill(0x811c9dc5u);
+
+        std::size_t i = 0;
+
+        for (; i + LANES <= size; i += LANES)
+        {
+            for (std::size_t lane = 0; lane < LANES; ++lane)
+            {
+                lanes[lane] = (lanes[lane] ^ std::bit_cast<std::uint32_t>(data[i + lane])) * 0x01000193u;
+            }
+        }
+
+        std::uint64_t hash = 0xcbf29ce484222325ull ^ size;
+
+        for (; i < size; ++i)      hash = (hash ^ std::bit_cast<std::uint32_t>(data[i])) * 0x100000001b3ull;
+        for (auto const lane : lanes) hash = (hash ^ lane) * 0x100000001b3ull;
+
+        return hash;
+    }
+}
+
+/******************************************************************************/
+// Thread Pool
+/******************************************************************************/
+
+namespace
+{
+    // Persistent worker threads, shared by every decoder in the process and
+    // started on first use; starting threads for every run, and again for
+    // every decoding pass, cost more than the work they did on quiet bands.
+    //
+    // Work is handed to the pool only when a thread is free to take it; a
+    // caller first reserves threads, then posts at most that many tasks, and
+    // does whatever it couldn't hand off on its own thread. Tasks therefore
+    // never wait in line behind one another, and a task may itself make use
+    // of the pool, as a mode decode does to demodulate, without any risk of
+    // deadlock. Tasks are referenced, not copied; the caller must keep each
+    // one alive until it's complete. Nothing here allocates once started.
+
+    class Pool
+    {
+        using Function = void (*)(void *);
+
+        struct Task
+        {
+            Function function = nullptr;
+            void   * context  = nullptr;
+        };
+
+        std::mutex               m_mutex;
+        std::condition_variable  m_ready;
+        std::vector<Task>        m_tasks;  // ring; no more pending than threads
+        std::size_t              m_head    = 0;
+        std::size_t              m_tail    = 0;
+        bool                     m_stop    = false;
+        std::atomic<std::size_t> m_available;
+        std::vector<std::thread> m_threads;
+
+        explicit Pool(std::size_t const size)
+        : m_tasks    (size)
+        , m_available(size)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                m_threads.emplace_back([this] { run(); });
+            }
+        }
+
+        void run()
+        {
+            for (;;)
+            {
+                Task task;
+
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+
+                    m_ready.wait(lock, [this] { return m_stop || m_head != m_tail; });
+
+                    if (m_head == m_tail) return;
+
+                    task = m_tasks[m_head++ % m_tasks.size()];
+                }
+
+                task.function(task.context);
+
+                m_available.fetch_add(1);
+            }
+        }
+
+    public:
+
+        ~Pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+
+            m_ready.notify_all();
+
+            for (auto & thread : m_threads) thread.join();
+        }
+
+        // The pool, sized to the hardware.
+
+        static Pool & instance()
+        {
+            static Pool pool(std::max(1u, std::thread::hardware_concurrency()));
+            return pool;
+        }
+
+        // Reserve up to the number of threads requested, returning the
+        // number actually reserved, which may well be none.
+
+        std::size_t reserve(std::size_t const wanted)
+        {
+            auto        available = m_available.load();
+            std::size_t taken;
+
+            do
+            {
+                taken = std::min(wanted, available);
+            }
+            while (taken && !m_available.compare_exchange_weak(available, available - taken));
+
+            return taken;
+        }
+
+        // Run a task, which must be callable without arguments, on one of
+        // the threads that we've reserved.
+
+        template <typename Callable>
+        void post(Callable & callable)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                m_tasks[m_tail++ % m_tasks.size()] = {[](void * const context)
+                {
+                    (*static_cast<Callable *>(context))();
+                }, &callable};
+            }
+
+            m_ready.notify_one();
+        }
+    };
 }
 
 /******************************************************************************/
@@ -1073,21 +1396,131 @@ namespace
     template <typename Mode>
     class DecodeMode
     {
+        // Working storage for the demodulation of a batch of candidates; the
+        // only storage written to by js8_downsample() and js8dec(), so we can
+        // speculatively run candidates in parallel, each thread making use of
+        // its own copy.
+
+        using Downsampled = std::array<std::complex<float>, NP>;
+
+        struct Scratch
+        {
+            alignas(64) std::array<std::complex<float>, NN * Mode::NDOWNSPS> csymb;
+            alignas(64) std::array<Downsampled, DOWNSAMPLE_BATCH>            cd0;
+
+            // Time spent in each stage by the thread using this storage;
+            // belief propagation is timed within demodulation.
+
+            std::chrono::steady_clock::duration downsampleTime;
+            std::chrono::steady_clock::duration demodulateTime;
+            std::chrono::steady_clock::duration bpTime;
+        };
+
+        // Number of symbol spectra computed by syncjs8(); the final few
+        // half-symbol steps don't have a full FFT's worth of data.
+
+        static constexpr int NSPECTRA = std::min(Mode::NHSYM, (Mode::NMAX - Mode::NFFT1) / Mode::NSTEP + 1);
+
+        static_assert(NSPECTRA >= SPECTRA_BATCH, "Spectra batch size exceeds spectra count");
+        static_assert(NSUB     >  NFILT,         "Subtraction block length must exceed filter length");
+
+        // Key of a cached spectrum; the position in the ring buffer of the
+        // first sample of the spectrum, and a hash of the samples.
+
+        struct CacheKey
+        {
+            int           position = -1;
+            std::uint64_t hash     =  0;
+
+            bool operator==(CacheKey const &) const noexcept = default;
+        };
+
+        // Results of demodulation of a single candidate by js8dec(); sync
+        // quality will be zero if the candidate failed the Costas check,
+        // and the decode will be present only if we passed CRC, in which
+        // case the tones are valid as well. Counts of the work done by the
+        // BP decoder, and of its results that failed CRC, are included for
+        // instrumentation.
+
+        struct Demod
+        {
+            float                 f1           =  0.0f;
+            float                 xdt          =  0.0f;
+            float                 sync         =  0.0f;
+            float                 xsnr         =  0.0f;
+            int                   nsync        =  0;
+            int                   nharderrors  = -1;
+            std::optional<Decode> decode;
+            std::array<int, NN>   itone;
+            int                   bpIterations =  0;
+            int                   bpFailures   =  0;
+            int                   crcRejects   =  0;
+        };
+
+        // A signal decoded by an earlier run over the same window; the ring
+        // buffer position of its first sample, its frequency, and its tones,
+        // from which we can subtract it without decoding it again, and the
+        // pass of the current run in which we found it, if we have.
+
+        struct Known
+        {
+            int                 start;
+            float               f1;
+            float               sync;
+            std::array<int, NN> itone;
+            int                 matched;
+        };
+
+        // Tolerances within which a sync candidate is taken to be a known
+        // signal. Sync resolves time to a quarter symbol and frequency to
+        // a bin, and js8dec() refines each by about that much again.
+
+        static constexpr int   KNOWN_SAMPLES   = Mode::NSPS / 2;
+        static constexpr float KNOWN_FREQUENCY = std::max(Mode::DF, NFSRCH * 0.5f);
+
         // Data members
 
         std::array<float, Mode::NFFT1>                                                nuttal;
-        std::array<std::array<std::array<std::complex<float>, Mode::NDOWNSPS>, 7>, 3> csyncs;
-        alignas(64) std::array<std::complex<float>, Mode::NDOWNSPS>                   csymb;
-        alignas(64) std::array<std::complex<float>, Mode::NMAX>                       filter;
-        alignas(64) std::array<std::complex<float>, Mode::NMAX>                       cfilt;
+        std::array<std::array<std::array<std::array<std::complex<float>, Mode::NDOWNSPS>, 7>, 3>, 2 * NFSRCH + 1> csyncs;
+        std::array<std::array<std::complex<float>, Mode::NSPS>, NROWS>                ctones;
+        std::array<std::complex<float>, Mode::NSPS>                                   ccarrier;
+        std::vector<std::complex<float>>                                              cref;
+        alignas(64) std::array<std::complex<float>, NSUB>                             filter;
+        alignas(64) std::array<std::complex<float>, NSUB>                             cfilt;
+        std::array<std::complex<float>, NFILT>                                        ctail;
         alignas(64) std::array<std::complex<float>, Mode::NDFFT1 / 2 + 1>             ds_cx;
-        alignas(64) std::array<std::complex<float>, Mode::NFFT1  / 2 + 1>             sd;
-        alignas(64) std::array<std::complex<float>, NP>                               cd0;
+        alignas(64) std::array<float, SPECTRA_BATCH * Mode::NFFT1>                    sd_in;
+        alignas(64) std::array<std::complex<float>, SPECTRA_BATCH * (Mode::NFFT1 / 2 + 1)> sd;
         std::array<float, Mode::NMAX>                                                 dd;
-        std::array<std::array<float, Mode::NHSYM>, Mode::NSPS>                        s;
+        std::array<std::array<float, Mode::NSPS>, Mode::NHSYM>                        s;
         std::array<float, Mode::NSPS>                                                 savg;
         FFTWPlanManager                                                               plans;
-        SyncIndex                                                                     sync;
+        std::vector<std::unique_ptr<Scratch>>                                         scratch;
+        std::vector<Demod>                                                            results;
+        std::vector<float>                                                            colsum;
+        std::vector<float>                                                            tsum;
+        std::vector<float>                                                            smax;
+        std::vector<int>                                                              jmax;
+        std::vector<Sync>                                                             sync;
+        std::vector<float>                                                            rank;
+        std::vector<std::size_t>                                                      order;
+        std::vector<bool>                                                             erased;
+        std::vector<Sync>                                                             candidates;
+        std::vector<int>                                                              pending;
+        std::vector<std::tuple<std::array<int, NN>, float, float>>                    subtractions;
+        std::vector<Known>                                                            known;
+        std::vector<CacheKey>                                                         cacheKeys;
+        std::vector<float>                                                            cachePower;
+        int                                                                           cacheEpoch     = 0;
+        int                                                                           primedIndex    = -1;
+        int                                                                           primedCount    = 0;
+        std::chrono::nanoseconds                                                      planTime       = {};
+        int                                                                           llrPasses      = FULL_LLR_PASSES;
+        BPVariant                                                                     bpVariant      = BPVariant::SumProduct;
+        bool                                                                          syncExact      = false;
+        std::chrono::steady_clock::duration                                           syncCost       = {};
+        std::array<std::chrono::steady_clock::duration, 2>                            candidateCost  = {};
+        std::chrono::steady_clock::duration                                           spectraTime    = {};
 
         using Plan = FFTWPlanManager::Type;
 
@@ -1143,14 +1576,11 @@ namespace
                                             Coefficients::SizeAtCompileTime / 2>{});
         }
 
-        std::optional<Decode>
-        js8dec(bool          const syncStats,
-               bool          const lsubtract,
-               float             & f1,
-               float             & xdt,
-               int               & nharderrors,
-               float             & xsnr,
-               JS8::Event::Emitter emitEvent)
+        Demod
+        js8dec(Scratch     & scratch,
+               Downsampled & cd0,
+               float         f1,
+               float         xdt) const
         {
             constexpr float FR  = 12000.0f / Mode::NFFT1;  // Frequency resolution
             constexpr float FS2 = 12000.0f / Mode::NDOWN;
@@ -1163,10 +1593,6 @@ namespace
             float delfbest = 0.0f;
             int   ibest    = 0;
 
-            // Downsample the signal and prepare for processing.
-
-            js8_downsample(f1);
-
             // Initial guess for the start of the signal.
 
             int   i0   = static_cast<int>(std::round((xdt + Mode::ASTART) * FS2));
@@ -1178,7 +1604,7 @@ namespace
                      idt <= i0 + Mode::NQSYMBOL;
                    ++idt)
             {
-                float const sync = syncjs8d(idt, 0.0f);
+                float const sync = syncjs8d(cd0, idt);
 
                 if (sync > smax) {
                     smax = sync;
@@ -1199,12 +1625,11 @@ namespace
                      ifr <=  NFSRCH;
                    ++ifr)
             {
-                float const delf = ifr * 0.5f;
-                float const sync = syncjs8d(i0, delf);
+                float const sync = syncjs8d(cd0, i0, ifr);
 
                 if (sync > smax) {
                     smax     = sync;
-                    delfbest = delf;
+                    delfbest = ifr * 0.5f;
                 }
             }
 
@@ -1222,31 +1647,45 @@ namespace
 
             // Adjust the frequency and time offset.
 
-            xdt = xdt2;
-            f1 += delfbest;
+            Demod result;
 
-            float const sync = syncjs8d(i0, 0.0f);
+            result.xdt  = xdt2;
+            result.f1   = f1 + delfbest;
+            result.sync = syncjs8d(cd0, i0);
 
-            std::array<std::array<float, NN>, NROWS> s2;
+            // Lay out all symbols contiguously, zero-filling any that lie
+            // outside the downsampled data, and transform them as a batch.
 
             for (int k = 0; k < NN; ++k)
             {
                 // Calculate the starting index for the current symbol.
 
-                int const i1 = ibest + k * Mode::NDOWNSPS;
-
-                csymb.fill(ZERO);
+                int  const i1    = ibest + k * Mode::NDOWNSPS;
+                auto const csymb = scratch.csymb.begin() + k * Mode::NDOWNSPS;
 
                 if (i1 >= 0 && i1 + Mode::NDOWNSPS <= NP2)
                 {
                     std::copy(cd0.begin() + i1,
                               cd0.begin() + i1 + Mode::NDOWNSPS,
-                              csymb.begin());
+                              csymb);
+                }
+                else
+                {
+                    std::fill_n(csymb, Mode::NDOWNSPS, ZERO);
                 }
+            }
+
+            fftwf_execute_dft(plans[Plan::CS],
+                              reinterpret_cast<fftwf_complex *>(scratch.csymb.data()),
+                              reinterpret_cast<fftwf_complex *>(scratch.csymb.data()));
+
+            // Normalize and take the magnitude of the first 8 points.
 
-                fftwf_execute(plans[Plan::CS]);
+            std::array<std::array<float, NN>, NROWS> s2;
 
-                // Normalize and take the magnitude of the first 8 points.
+            for (int k = 0; k < NN; ++k)
+            {
+                auto const csymb = scratch.csymb.begin() + k * Mode::NDOWNSPS;
 
                 for (int i = 0; i < NROWS; ++i)
                 {
@@ -1286,13 +1725,9 @@ namespace
 
             // If the sync quality isn't at least 7, this one's a loser.
 
-            if (nsync <= 6) return std::nullopt;
+            if (nsync <= 6) return result;
 
-            if (syncStats) emitEvent(JS8::Event::SyncState{JS8::Event::SyncState::Type::CANDIDATE,
-                                                           Mode::NSUBMODE,
-                                                           f1,
-                                                           xdt,
-                                                           {.candidate = nsync}});
+            result.nsync = nsync;
 
             std::array<std::array<float, ND>, NROWS> s1;
 
@@ -1362,7 +1797,7 @@ namespace
             std::array<int8_t, N> cw;
 
             // Loop over decoding passes
-            for (int ipass = 1; ipass <= 4; ++ipass)
+            for (int ipass = 1; ipass <= llrPasses; ++ipass)
             {
                 // LLR 0 used on passes 1, 3, and 4; LLR 1 used on pass 2.
 
@@ -1376,8 +1811,17 @@ namespace
 
                 // Decode using belief propagation.
 
-                nharderrors = bpdecode174(llr, decoded, cw);
-                xsnr        = -99.0f;
+                int iterations;
+
+                {
+                    ScopedTimer timer(scratch.bpTime);
+                    result.nharderrors = bpdecode174(bpVariant, llr, decoded, cw, iterations);
+                }
+
+                result.xsnr          = -99.0f;
+                result.bpIterations += iterations;
+
+                if (result.nharderrors < 0) ++result.bpFailures;
 
                 // Check for all-zero codeword
                 if (std::all_of(cw.begin(), cw.end(), [](int x) { return x == 0; }))
@@ -1385,62 +1829,54 @@ namespace
                     continue;
                 }
 
-                if (nharderrors >= 0    && nharderrors < 60  &&
-                    !(sync      <  2.0f && nharderrors > 35) &&
-                    !(ipass     >  2    && nharderrors > 39) &&
-                    !(ipass     == 4    && nharderrors > 30))
+                if (result.nharderrors >= 0    && result.nharderrors < 60  &&
+                    !(result.sync      <  2.0f && result.nharderrors > 35) &&
+                    !(ipass            >  2    && result.nharderrors > 39) &&
+                    !(ipass            == 4    && result.nharderrors > 30))
                 {
                    if (checkCRC12(decoded))
                    {
-                        if (syncStats) emitEvent(JS8::Event::SyncState{JS8::Event::SyncState::Type::DECODED,
-                                                                       Mode::NSUBMODE,
-                                                                       f1,
-                                                                       xdt2,
-                                                                       {.decoded = sync}});
-
                         auto message = extractmessage174(decoded);
 
                         int const i3bit = (decoded[72] << 2) |
                                           (decoded[73] << 1) |
                                            decoded[74];
 
-                        std::array<int, NN> itone;
-
-                        JS8::encode(i3bit, Costas, message.data(), itone.data());
-
-                        // Subtract signal if needed.
-
-                        if (lsubtract) subtractjs8(genjs8refsig(itone, f1), xdt2);
+                        JS8::encode(i3bit, Costas, message.data(), result.itone.data());
 
                         // Compute the signal power.
 
                         float xsig = 0.0f;
 
-                        for (std::size_t i = 0; i < itone.size(); ++i)
+                        for (std::size_t i = 0; i < result.itone.size(); ++i)
                         {
-                            xsig += std::pow(s2[itone[i]][i], 2);
+                            xsig += std::pow(s2[result.itone[i]][i], 2);
                         }
 
                         // Compute SNR, clamping results lower than -28 to -28.
                         // Note that std::log10(1.259e-10) is about -9.9; we're
                         // avoiding undefined behavior in the log10 computation.
 
-                        xsnr = std::max(
+                        result.xsnr = std::max(
                             10.0f * std::log10(std::max(
                                 xsig / xbase -  1.0f,
                                 1.259e-10f)) - 32.0f,
                            -60.0f);  // XXX was -28.0f in Fortran
 
-                        return std::make_optional<Decode>(i3bit, message);
+                        result.decode.emplace(i3bit, std::move(message));
+
+                        return result;
                    }
+
+                   ++result.crcRejects;
                 }
                 else
                 {
-                    nharderrors = -1;
+                    result.nharderrors = -1;
                 }
             }
 
-            return std::nullopt;
+            return result;
         }
 
         // Compute noise baseline. We differ quite a bit from the Fortran
@@ -1583,68 +2019,282 @@ namespace
 
         // This function extracts a narrow frequency band around the target frequency f0,
         // applies tapering to reduce spectral artifacts, aligns the signal to the center
-        // frequency, performs an inverse FFT to convert the data back into the time domain,
-        // and normalizes the result for further processing in the JS8 decoding pipeline.
+        // frequency, and performs an inverse FFT to convert the data back into the time
+        // domain, normalized for further processing in the JS8 decoding pipeline. It's
+        // done for a batch of candidates at a time; candidate i of the batch is placed
+        // in scratch.cd0[i]. A full batch is transformed by a single execution of the
+        // batched plan.
 
         void
-        js8_downsample(float const f0)
+        js8_downsample(Scratch           & scratch,
+                       Sync        const * batch,
+                       std::size_t const   count) const
         {
-            // Frequency band extraction; identifies a narrow frequency band around the
-            // target frequency (f0) based on a predefined range (8.5 baud above and 1.5
-            // baud below). The indices of this range in the frequency-domain representation
-            // (ds_cx) are calculated (ib and it), and the relevant frequency-domain samples
-            // are extracted into cd0.
-
             constexpr float DF   = 12000.0f / Mode::NDFFT1;
             constexpr float BAUD = 12000.0f / Mode::NSPS;
 
-            float const ft = f0 + 8.5f * BAUD;
-            float const fb = f0 - 1.5f * BAUD;
-            int   const i0 =             static_cast<int>(std::round(f0 / DF));
-            int   const it = std::min(   static_cast<int>(std::round(ft / DF)), Mode::NDFFT1 / 2);
-            int   const ib = std::max(0, static_cast<int>(std::round(fb / DF)));
+            // The time-domain samples must be normalized by a factor derived from the
+            // input and output FFT sizes (Mode::NDFFT1 and Mode::NDFFT2), ensuring
+            // consistency in the signal's amplitude. Since the inverse FFT is linear,
+            // we fold this into the tapering step.
+
+            float const factor = 1.0f / std::sqrt(static_cast<float>(Mode::NDFFT1) * Mode::NDFFT2);
+
+            for (std::size_t b = 0; b < count; ++b)
+            {
+                float const f0 = batch[b].freq;
+
+                // Frequency band extraction; identifies a narrow frequency band around the
+                // target frequency (f0) based on a predefined range (8.5 baud above and 1.5
+                // baud below). The indices of this range in the frequency-domain representation
+                // (ds_cx) are calculated (ib and it), and the relevant frequency-domain samples
+                // are extracted into cd0.
 
-            std::size_t const NDD_SIZE = Mode::NDD + 1;
-            std::size_t const RANGE_SIZE = it - ib + 1;
+                float const ft = f0 + 8.5f * BAUD;
+                float const fb = f0 - 1.5f * BAUD;
+                int   const i0 =             static_cast<int>(std::round(f0 / DF));
+                int   const it = std::min(   static_cast<int>(std::round(ft / DF)), Mode::NDFFT1 / 2);
+                int   const ib = std::max(0, static_cast<int>(std::round(fb / DF)));
 
-            std::fill_n(cd0.begin(), Mode::NDFFT2, ZERO);
+                int const RANGE_SIZE = it - ib + 1;
+                int const TAIL_START = RANGE_SIZE - (Mode::NDD + 1);
+                int const SHIFT      = i0 - ib;
 
-            std::copy(ds_cx.begin() + ib,
-                      ds_cx.begin() + ib + RANGE_SIZE,
-                      cd0.begin());
+                auto & cd0 = scratch.cd0[b];
 
-            // Tapering is applied to smooth the edges of the frequency band, reducing
-            // spectral leakage during the inverse FFT. Reversed taper at the beginning,
-            // normal taper at the end.
+                std::fill_n(cd0.begin(), Mode::NDFFT2, ZERO);
 
-            auto const head = cd0.begin();
-            auto const tail = cd0.begin() + RANGE_SIZE;
+                // Tapering is applied to smooth the edges of the frequency band, reducing
+                // spectral leakage during the inverse FFT; reversed taper at the beginning,
+                // normal taper at the end. The extracted frequency band is aligned to the
+                // center of the frequency domain representation (i0 - ib) via a cyclic
+                // shift as we place it. This centers the desired signal.
 
-            std::transform(head, head + NDD_SIZE, Taper[0].begin(), head,            std::multiplies<>());
-            std::transform(tail - NDD_SIZE, tail, Taper[1].begin(), tail - NDD_SIZE, std::multiplies<>());
+                for (int k = 0; k < RANGE_SIZE; ++k)
+                {
+                    float gain = factor;
 
-            // The extracted frequency band is aligned to the center of the frequency domain
-            // representation (i0 - ib) via a cyclic shift using std::rotate. This centers
-            // the desired signal.
+                    if (k <= Mode::NDD)  gain *= Taper[0][k];
+                    if (k >= TAIL_START) gain *= Taper[1][k - TAIL_START];
 
-            std::rotate(cd0.begin(), cd0.begin() + (i0 - ib), cd0.begin() + Mode::NDFFT2);
+                    cd0[k < SHIFT ? k - SHIFT + Mode::NDFFT2
+                                  : k - SHIFT] = ds_cx[ib + k] * gain;
+                }
+            }
 
             // An inverse FFT is performed on the frequency-domain data (cd0) to transform it
             // back into the time domain, effectively yielding a downsampled, time-domain signal
             // focused on the extracted narrow frequency band.
 
-            fftwf_execute(plans[Plan::DS]);
+            if (count == DOWNSAMPLE_BATCH)
+            {
+                fftwf_execute_dft(plans[Plan::DB],
+                                  reinterpret_cast<fftwf_complex *>(scratch.cd0.data()),
+                                  reinterpret_cast<fftwf_complex *>(scratch.cd0.data()));
+            }
+            else
+            {
+                for (std::size_t b = 0; b < count; ++b)
+                {
+                    fftwf_execute_dft(plans[Plan::DS],
+                                      reinterpret_cast<fftwf_complex *>(scratch.cd0[b].data()),
+                                      reinterpret_cast<fftwf_complex *>(scratch.cd0[b].data()));
+                }
+            }
+        }
 
-            // The resulting time-domain samples are normalized by a factor derived from the
-            // input and output FFT sizes (Mode::NDFFT1 and Mode::NDFFT2), ensuring consistency
-            // in the signal’s amplitude.
+        // Compute symbol spectra [first, last) of the data. If we've been
+        // told the ring buffer position of the data, then it's unaltered by
+        // subtraction, and any spectrum of the same samples at the same
+        // position, e.g., from an earlier decode of an overlapping window,
+        // can be taken from the cache. The cache is direct-mapped by
+        // position, so a miss evicts whatever spectrum was at that slot.
 
-            float const factor = 1.0f / std::sqrt(static_cast<float>(Mode::NDFFT1) * Mode::NDFFT2);
+        void
+        computeSpectra(int const position,
+                       int const first,
+                       int const last)
+        {
+            pending.clear();
+
+            for (int j = first; j < last; ++j)
+            {
+                if (position < 0)
+                {
+                    pending.push_back(j);
+                    continue;
+                }
+
+                int  const start = (position + j * Mode::NSTEP) % JS8_RX_SAMPLE_SIZE;
+                auto const slot  = static_cast<std::size_t>(start / Mode::NSTEP % NSPECTRA);
+                auto const key   = CacheKey{start, hashSamples(dd.data() + j * Mode::NSTEP, Mode::NFFT1)};
+
+                if (cacheKeys[slot] == key)
+                {
+                    std::copy_n(cachePower.begin() + slot * Mode::NSPS,
+                                Mode::NSPS,
+                                s[j].begin());
+                }
+                else
+                {
+                    cacheKeys[slot] = key;
+                    pending.push_back(j);
+                }
+            }
+
+            // Compute any spectra that we didn't find in the cache, a batch
+            // at a time, zero-filling any unused portion of the final batch.
+
+            for (std::size_t p0 = 0; p0 < pending.size(); p0 += SPECTRA_BATCH)
+            {
+                auto const count = std::min(pending.size() - p0, static_cast<std::size_t>(SPECTRA_BATCH));
+
+                // Window each segment of the batch into the batch buffer.
+
+                for (std::size_t b = 0; b < count; ++b)
+                {
+                    int const ia = pending[p0 + b] * Mode::NSTEP;
+
+                    std::transform(dd.begin() + ia,
+                                   dd.begin() + ia + Mode::NFFT1,
+                                   nuttal.begin(),
+                                   sd_in.begin() + b * Mode::NFFT1,
+                                   std::multiplies<float>{});
+                }
+
+                std::fill(sd_in.begin() + count * Mode::NFFT1, sd_in.end(), 0.0f);
+
+                fftwf_execute(plans[Plan::SD]);
+
+                // Compute power spectra, caching them if we're able.
+
+                for (std::size_t b = 0; b < count; ++b)
+                {
+                    int  const j        = pending[p0 + b];
+                    auto const spectrum = sd.begin() + b * (Mode::NFFT1 / 2 + 1);
+
+                    std::transform(spectrum,
+                                   spectrum + Mode::NSPS,
+                                   s[j].begin(),
+                                   [](auto const value) { return std::norm(value); });
+
+                    if (position >= 0)
+                    {
+                        int  const start = (position + j * Mode::NSTEP) % JS8_RX_SAMPLE_SIZE;
+                        auto const slot  = static_cast<std::size_t>(start / Mode::NSTEP % NSPECTRA);
+
+                        std::copy_n(s[j].begin(),
+                                    Mode::NSPS,
+                                    cachePower.begin() + slot * Mode::NSPS);
+                    }
+                }
+            }
+        }
+
+        // For each of the bins starting at ia, find the lag at which the
+        // Costas arrays best line up, leaving the sync metric at that lag
+        // in smax, and the lag in jmax. Spectra are stored time-major, so
+        // for a given lag and Costas position, the tone power of adjacent
+        // bins is adjacent in memory; we evaluate each lag for all bins at
+        // once.
+
+        void
+        searchSync(int         const ia,
+                   std::size_t const bins)
+        {
+            smax.assign(bins, -std::numeric_limits<float>::infinity());
+            jmax.assign(bins, -Mode::JZ);
+            tsum.resize(6 * bins);
+
+            // Unless we've been asked for exact results, compute the sum over
+            // all 7 tones of each bin once for each time step; every lag will
+            // use these in place of summing the tones itself.
+
+            if (!syncExact)
+            {
+                colsum.resize(Mode::NHSYM * bins);
+
+                for (int k = 0; k < Mode::NHSYM; ++k)
+                {
+                    auto const row = s[k].data() + ia;
+                    auto const sum = colsum.data() + k * bins;
+
+                    std::fill_n(sum, bins, 0.0f);
+
+                    for (int freq = 0; freq < 7; ++freq)
+                    {
+                        for (std::size_t i = 0; i < bins; ++i) sum[i] += row[i + NFOS * freq];
+                    }
+                }
+            }
+
+            for (int j = -Mode::JZ; j <= Mode::JZ; ++j)
+            {
+                // Sums of Costas pattern contributions and of all tones, for
+                // each of the 3 Costas arrays, for each bin.
+
+                std::fill(tsum.begin(), tsum.end(), 0.0f);
+
+                for (int p = 0; p < 3; ++p)
+                {
+                    auto const tx = tsum.data() + p       * bins;
+                    auto const t0 = tsum.data() + (p + 3) * bins;
+
+                    for (int n = 0; n < 7; ++n)
+                    {
+                        int const offset = j + Mode::JSTRT + NSSY * n + p * 36 * NSSY;
+
+                        if (offset < 0 || offset >= Mode::NHSYM) continue;
+
+                        auto const row = s[offset].data() + ia;
+
+                        // Accumulate Costas pattern contributions.
+
+                        for (std::size_t i = 0; i < bins; ++i) tx[i] += row[i + NFOS * Costas[p][n]];
+
+                        // Accumulate sum over all frequencies for this block.
 
-            std::transform(cd0.begin(),
-                           cd0.end(),
-                           cd0.begin(),
-                           [factor](auto & value) { return value * factor; });
+                        if (syncExact)
+                        {
+                            for (int freq = 0; freq < 7; ++freq)
+                            {
+                                for (std::size_t i = 0; i < bins; ++i) t0[i] += row[i + NFOS * freq];
+                            }
+                        }
+                        else
+                        {
+                            auto const sum = colsum.data() + offset * bins;
+
+                            for (std::size_t i = 0; i < bins; ++i) t0[i] += sum[i];
+                        }
+                    }
+                }
+
+                // Compute sync metric over the index range; all three variants
+                // share partial sums, added in the same order that the Fortran
+                // version added them, so that exact mode remains exact. IEEE 754
+                // addition is a touchy thing.
+
+                for (std::size_t i = 0; i < bins; ++i)
+                {
+                    float const tx01 = tsum[i]            + tsum[i + bins];
+                    float const t001 = tsum[i + 3 * bins] + tsum[i + 4 * bins];
+                    float const tx02 = tx01 + tsum[i + 2 * bins];
+                    float const t002 = t001 + tsum[i + 5 * bins];
+                    float const tx12 = tsum[i + bins]     + tsum[i + 2 * bins];
+                    float const t012 = tsum[i + 4 * bins] + tsum[i + 5 * bins];
+
+                    if (auto const sync_value = std::max({
+                            tx02 / ((t002 - tx02) / 6.0f),
+                            tx01 / ((t001 - tx01) / 6.0f),
+                            tx12 / ((t012 - tx12) / 6.0f)
+                        }); sync_value > smax[i])
+                    {
+                        smax[i] = sync_value;
+                        jmax[i] = j;
+                    }
+                }
+            }
         }
 
         // Evaluate the synchronization power of signal segments, ranks potential candidates, and
@@ -1705,37 +2355,25 @@ namespace
         //       so it was effectively a somewhat expensive dead store. It's been eliminated
         //       in this version.
 
-        std::vector<Sync>
-        syncjs8(int nfa,
-                int nfb)
+        std::vector<Sync> &
+        syncjs8(int       nfa,
+                int       nfb,
+                int const position = -1)
         {
-            // Compute symbol spectra
-
-            savg.fill(0.0f);
+            // Compute symbol spectra.
 
-            for (int j = 0; j < Mode::NHSYM; ++j)
             {
-                int const ia = j  * Mode::NSTEP;
-                int const ib = ia + Mode::NFFT1;
-
-                if (ib > Mode::NMAX) break;
-
-                std::transform(dd.begin() + ia,
-                               dd.begin() + ib,
-                               nuttal.begin(),
-                               reinterpret_cast<float *>(sd.data()),
-                               std::multiplies<float>{});
+                ScopedTimer timer(spectraTime);
+                computeSpectra(position, 0, NSPECTRA);
+            }
 
-                fftwf_execute(plans[Plan::SD]);
+            // Compute the average spectrum.
 
-                // Compute power spectrum
+            savg.fill(0.0f);
 
-                for (int i = 0; i < Mode::NSPS; ++i)
-                {
-                    auto const power = std::norm(sd[i]);
-                    s[i][j]  = power;
-                    savg[i] += power;
-                }
+            for (int j = 0; j < NSPECTRA; ++j)
+            {
+                for (int i = 0; i < Mode::NSPS; ++i) savg[i] += s[j][i];
             }
 
             // Filter edge sanity measures
@@ -1765,132 +2403,116 @@ namespace
             // Compute and populate the sync index.
 
             sync.clear();
+            candidates.clear();
 
-            for (int i = ia; i <= ib; ++i)
-            {
-                float max_value = -std::numeric_limits<float>::infinity();
-                int   max_index = -Mode::JZ;
-
-                for (int j = -Mode::JZ; j <= Mode::JZ; ++j)
-                {
-                    std::array<std::array<float, 3>, 2> t{};
-
-                    for (int p = 0; p < 3; ++p)
-                    {
-                        for (int n = 0; n < 7; ++n)
-                        {
-                            int const offset = j + Mode::JSTRT + NSSY * n + p * 36 * NSSY;
-
-                            if (offset >= 0 && offset < Mode::NHSYM)
-                            {
-                                // Accumulate Costas pattern contributions.
-
-                                t[0][p] += s[i + NFOS * Costas[p][n]][offset];
-
-                                // Accumulate sum over all frequencies for this block.
-
-                                for (int freq = 0; freq < 7; ++freq)
-                                {
-                                    t[1][p] += s[i + NFOS * freq][offset];
-                                }
-                            }
-                        }
-                    }
-
-                    // Compute sync metric over the index range. We are at the moment
-                    // maintaining the Fortran summation methodology for compatibility
-                    // testing; there are more efficient ways to do this, but IEEE 754
-                    // addition is a touchy thing, so we'll need to ensure that any
-                    // changes don't negatively affect result precision.
-
-                    auto const compute_sync = [&t](int start, int end)
-                    {
-                        float tx = 0.0f;
-                        float t0 = 0.0f;
-
-                        for (int i = start; i <= end; ++i)
-                        {
-                            tx += t[0][i];
-                            t0 += t[1][i];
-                        }
+            if (ib < ia) return candidates;
 
-                        return tx / ((t0 - tx) / 6.0f);
-                    };
+            auto const bins = static_cast<std::size_t>(ib - ia + 1);
 
-                    if (auto const sync_value = std::max({
-                            compute_sync(0, 2),
-                            compute_sync(0, 1),
-                            compute_sync(1, 2)
-                        }); sync_value > max_value)
-                    {
-                        max_value = sync_value;
-                        max_index = j;
-                    }
-                }
+            searchSync(ia, bins);
 
-                sync.emplace(Mode::DF    * i,
-                             Mode::TSTEP * (max_index + 0.5f),
-                                            max_value);
+            for (std::size_t i = 0; i < bins; ++i)
+            {
+                sync.emplace_back(Mode::DF    * (ia + static_cast<int>(i)),
+                                  Mode::TSTEP * (jmax[i] + 0.5f),
+                                                 smax[i]);
             }
 
-            // If we found nothing, we're done here.
-
-            if (sync.empty()) return {};
-
-            // Access the sync indices.
-
-            auto & freqIndex = sync.get<Tag::Freq>();
-            auto & rankIndex = sync.get<Tag::Rank>();
-            auto & syncIndex = sync.get<Tag::Sync>();
+            // The sync entries are now in ascending frequency order, which
+            // is the order in which we'll look for near-duplicates. Rank them
+            // by descending sync value, ties in ascending frequency order, i.e.,
+            // by index; any NaN values sort last. Dividing by a positive
+            // normalizer won't change this order, so we can rank prior to
+            // normalizing.
 
-            // Normalize to the 40th percentile using the frequency index,
-            // which is stable under sync value mutation. One thing to note
-            // here is that the Fortran version didn't seem to reliably
-            // calculate the 40th percentile rank; sometimes high, other
-            // times low, infrequently actually the 40th percentile value.
-            // This method should be perfectly accurate in all cases.
-
-            auto const normalize =
-            [
-               sync = rankIndex.nth(rankIndex.size() * 4 / 10)->sync
-            ]
-            (Sync & entry)
+            auto const greater = [](float const a,
+                                    float const b)
             {
-                entry.sync /= sync;
+                return std::isnan(b) ? !std::isnan(a) : a > b;
             };
 
-            for (auto it  = freqIndex.begin();
-                      it != freqIndex.end();
-                    ++it)
+            order.resize(sync.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(),
+                      order.end(),
+                      [&](auto const a,
+                          auto const b)
+                      {
+                         if (greater(sync[a].sync, sync[b].sync)) return true;
+                         if (greater(sync[b].sync, sync[a].sync)) return false;
+
+                         return a < b;
+                      });
+
+            // Normalize to the 40th percentile. One thing to note here is
+            // that the Fortran version didn't seem to reliably calculate the
+            // 40th percentile rank; sometimes high, other times low, but
+            // infrequently actually the 40th percentile value. This method
+            // should be perfectly accurate in all cases.
+
+            rank.resize(sync.size());
+            std::transform(sync.begin(),
+                           sync.end(),
+                           rank.begin(),
+                           [](auto const & entry) { return entry.sync; });
+
+            auto const nth = rank.begin() + rank.size() * 4 / 10;
+
+            std::nth_element(rank.begin(),
+                             nth,
+                             rank.end(),
+                             [&](auto const a,
+                                 auto const b)
+                             {
+                                return greater(b, a);
+                             });
+
+            for (auto & entry : sync) entry.sync /= *nth;
+
+            // Extract candidates, strongest first, removing any near-duplicates
+            // of each candidate based on frequency as we go.
+
+            erased.assign(sync.size(), false);
+
+            for (auto const index : order)
             {
-                freqIndex.modify(it, normalize);
-            }
+                if (candidates.size() >= NMAXCAND) break;
+                if (erased[index])                 continue;
 
-            // Extract candidates.
+                auto const & entry = sync[index];
 
-            std::vector<Sync> candidates;
-
-            for (auto it  = syncIndex.begin();
-                      it != syncIndex.end() && candidates.size() < NMAXCAND;
-                      it  = syncIndex.begin())
-            {
                 // Stop iteration if below threshold or invalid; as the
-                // index is sorted by sync, any subsequent entries will
-                // also be below the threshold or invalid.
+                // order is by sync, any subsequent entries will also be
+                // below the threshold or invalid.
 
-                if (it->sync < ASYNCMIN || std::isnan(it->sync)) break;
+                if (entry.sync < ASYNCMIN || std::isnan(entry.sync)) break;
 
                 // Good value, relatively strong; save the candidate.
 
-                candidates.push_back(*it);
-
-                // Remove the candidate and any near-duplicates based
-                // on frequency. This invalidates `it`, so we reset it
-                // to the index begin in the loop increment condition.
-
-                freqIndex.erase(
-                    freqIndex.lower_bound(it->freq - Mode::AZ),
-                    freqIndex.upper_bound(it->freq + Mode::AZ));
+                candidates.push_back(entry);
+
+                // Remove any near-duplicates based on frequency.
+
+                auto const lower = std::lower_bound(sync.begin(),
+                                                    sync.end(),
+                                                    entry.freq - Mode::AZ,
+                                                    [](auto const & e,
+                                                       auto const   f)
+                                                    {
+                                                        return e.freq < f;
+                                                    });
+                auto const upper = std::upper_bound(lower,
+                                                    sync.end(),
+                                                    entry.freq + Mode::AZ,
+                                                    [](auto const   f,
+                                                       auto const & e)
+                                                    {
+                                                        return f < e.freq;
+                                                    });
+
+                std::fill(erased.begin() + (lower - sync.begin()),
+                          erased.begin() + (upper - sync.begin()),
+                          true);
             }
 
             return candidates;
@@ -1899,43 +2521,16 @@ namespace
         // Returns the total synchronization power, which is a measure of how well
         // the signal aligns with the Costas sequence after accounting for the
         // frequency adjustment. Used to identify the best alignment for further
-        // decoding.
+        // decoding. The frequency adjustment is specified in steps of 0.5 Hz,
+        // in the range [-NFSRCH, NFSRCH]; the Costas waveforms, adjusted by
+        // each of these and conjugated, were computed by the constructor.
 
         float
-        syncjs8d(int   const i0,
-                 float const delf)
+        syncjs8d(Downsampled const & cd0,
+                 int         const   i0,
+                 int         const   ifr = 0) const
         {
-            constexpr float BASE_DPHI = TAU * (1.0f / (12000.0f / Mode::NDOWN));
-
-            // If delta frequency is non-zero, compute the frequency
-            // adjustment array, otherwise, use what'll be an identity
-            // transfrom when multiplied.
-
-            std::array<std::complex<float>, Mode::NDOWNSPS> freqAdjust;
-
-            if (delf != 0.0f)
-            {
-                float const dphi = BASE_DPHI * delf;
-                float       phi  = 0.0f;
-
-                // std::fmod() is almost like Fortran's mod(), but not quite;
-                // Since delf can be negative, we must ensure that phi stays
-                // within [0, TAU), which Fortran's mod() handles by itself.
-
-                for (int i = 0; i < Mode::NDOWNSPS; ++i)
-                {
-                    freqAdjust[i] = std::polar(1.0f, phi);
-                    if (phi = std::fmod(phi + dphi, TAU);
-                        phi < 0.0f)
-                    {
-                        phi += TAU;
-                    }
-                }
-            }
-            else
-            {
-                freqAdjust.fill(std::complex<float>{1.0f, 0.0f});
-            }
+            auto const & csync = csyncs[ifr + NFSRCH];
 
             // Compute sync power by looping over the Costas indices for
             // each of the 3 Costas blocks, accumulating as we go.
@@ -1952,15 +2547,15 @@ namespace
                     {
                         sync += std::norm(
                             std::transform_reduce(
-                                freqAdjust.begin(),     // Range start
-                                freqAdjust.end(),       // Range end
-                                cd0.begin() + offset,   // Data start
-                                std::complex<float>{},  // Initial reduction value
-                                std::plus<>{},          // Reduction by accumulation
-                                [&](auto const & fa,    // Conjugate and multiply
-                                    auto const & cd)
+                                csync[i][j].begin(),          // Range start
+                                csync[i][j].end(),            // Range end
+                                cd0.begin() + offset,         // Data start
+                                std::complex<float>{},        // Initial reduction value
+                                std::plus<>{},                // Reduction by accumulation
+                                [](auto const & cs,           // Multiply
+                                   auto const & cd)
                                 {
-                                    return cd * std::conj(fa * csyncs[i][j][&fa - &freqAdjust[0]]);
+                                    return cd * cs;
                                 }
                             ));
                     }
@@ -1973,37 +2568,46 @@ namespace
         // Generate a reference signal, based on the provided tone sequence and
         // base frequency. The output is a vector of complex values representing
         // the signal in the time domain.
-
-        std::vector<std::complex<float>>
+        //
+        // Each tone completes a whole number of cycles in a symbol, so tone
+        // phase is the same at the start of every symbol; the reference is
+        // the product of the base frequency carrier and the tone waveforms
+        // computed by the constructor. The carrier, in turn, is the product
+        // of its phase at the start of each symbol and a single symbol of it.
+        // Phases are computed directly rather than accumulated, in order to
+        // avoid drift over the length of the signal.
+
+        std::vector<std::complex<float>> const &
         genjs8refsig(std::array<int, NN> const & itone,
                      float               const   f0)
         {
-            // Precompute the base frequency contribution; full circle in
+            // Base frequency phase increment per sample; full circle in
             // radians, multipled by the base frequency, multiplied by the
-            // sampling interval, i.e., the time step between samples, which
-            // results in the base frequency phase increment. Start the
-            // phase accumulator off at zero.
+            // sampling interval, i.e., the time step between samples.
 
-            float const BFPI = TAU * f0 * (1.0f / 12000.0f);
-            auto        phi  = 0.0f;
+            double const BFPI = 2.0 * std::numbers::pi * f0 * (1.0 / 12000.0);
 
-            std::vector<std::complex<float>> cref;
-            cref.reserve(NN * Mode::NSPS);
+            auto const phase = [BFPI](int const n)
+            {
+                return static_cast<float>(std::fmod(BFPI * n, 2.0 * std::numbers::pi));
+            };
 
-            for (int i = 0; i < NN; ++i)
+            for (int n = 0; n < Mode::NSPS; ++n)
             {
-                // Compute phase increment for the tone; frequency offset is
-                // determined by the tone value.
+                ccarrier[n] = std::polar(1.0f, phase(n));
+            }
 
-                float const dphi = BFPI + TAU * static_cast<float>(itone[i]) / Mode::NSPS;
+            cref.resize(NN * Mode::NSPS);
 
-                // Iterate over the samples per symbol to generate the time
-                // domain signal.
+            for (int i = 0; i < NN; ++i)
+            {
+                auto const   start = std::polar(1.0f, phase(i * Mode::NSPS));
+                auto const & tone  = ctones[itone[i]];
+                auto const   out   = cref.begin() + i * Mode::NSPS;
 
-                for (std::size_t is = 0; is < Mode::NSPS; ++is)
+                for (int n = 0; n < Mode::NSPS; ++n)
                 {
-                    cref.push_back(std::polar(1.0f, phi));
-                    phi = std::fmod(phi + dphi, TAU);
+                    out[n] = start * (ccarrier[n] * tone[n]);
                 }
             }
 
@@ -2018,49 +2622,193 @@ namespace
         // Subtract         : dd(t)    = dd(t) - 2*REAL{cref*cfilt}
         //
         // Important to note that dt can be negative here.
+        //
+        // The filter is applied by overlap-save over the span of the signal
+        // only, a block of NSUB samples at a time, rather than by transforms
+        // of the full buffer. The filter has NFILT + 1 taps, so each block
+        // yields NSUB - NFILT new outputs, carrying the last NFILT inputs of
+        // each block over to the next. Block outputs lag the block inputs,
+        // so we can subtract each block as we go without disturbing input
+        // to the blocks that follow.
 
         void
         subtractjs8(std::vector<std::complex<float>> const & cref,
                     float                            const   dt)
         {
+            constexpr std::size_t BLOCK = NSUB - NFILT;
+
             auto        const nstart     = static_cast<int>(dt * 12000.0f);
             std::size_t const cref_start = (nstart < 0) ? static_cast<std::size_t>(-nstart) : 0;
             std::size_t const dd_start   = (nstart > 0) ? static_cast<std::size_t>( nstart) : 0;
             auto        const size       = std::min(cref.size() - cref_start, dd.size() - dd_start);
 
-            // Populate complex filter with the conjugate of the reference signal.
+            // Nothing precedes the signal.
 
-            for (std::size_t i = 0; i < size; ++i)
+            ctail.fill(ZERO);
+
+            for (std::size_t block = 0; block < size; block += BLOCK)
+            {
+                auto const count = std::min(BLOCK, size - block);
+
+                // Populate complex filter with the carried over inputs and
+                // the conjugate of the reference signal for this block,
+                // zero-filling the remainder, if any. Save the inputs that
+                // the next block will require.
+
+                std::copy(ctail.begin(), ctail.end(), cfilt.begin());
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    cfilt[NFILT + i] = dd[dd_start + block + i] * std::conj(cref[cref_start + block + i]);
+                }
+
+                std::fill(cfilt.begin() + NFILT + count, cfilt.end(), ZERO);
+                std::copy(cfilt.end() - NFILT, cfilt.end(), ctail.begin());
+
+                // FFT to the frequency domain.
+
+                fftwf_execute(plans[Plan::CF]);
+
+                // Apply the filter in the frequency domain.
+
+                std::transform(cfilt.begin(),
+                               cfilt.end(),
+                               filter.begin(),
+                               cfilt.begin(),
+                               std::multiplies<>());
+
+                // Inverse FFT to return to the time domain.
+
+                fftwf_execute(plans[Plan::CB]);
+
+                // Subtract the reconstructed signal.
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    dd[dd_start + block + i] -= 2.0f * std::real(cfilt[NFILT + i] * cref[cref_start + block + i]);
+                }
+            }
+        }
+
+        // Demodulate all the candidates of a decoding pass. Demodulation
+        // depends only on the baseband FFT and the baseline, neither of
+        // which change during a pass; subtraction affects only the next
+        // pass. On busy bands we can therefore demodulate speculatively
+        // in parallel, each thread using its own scratch storage, with
+        // results identical to those of a serial run. Helpers come from
+        // the threads of the pool that are free at the time, so however
+        // many modes and decoders are running, we don't oversubscribe;
+        // if there are none free, we'll do it all ourselves. Results are
+        // reused from pass to pass.
+
+        std::vector<Demod> &
+        demodulate(std::vector<Sync>                     const & candidates,
+                   std::chrono::steady_clock::time_point const   deadline,
+                   JS8::Event::DecodeStats                     & stats)
+        {
+            results.assign(candidates.size(), Demod{});
+
+            auto     & pool    = Pool::instance();
+            auto const helpers = candidates.size() < SPECULATIVE_MIN
+                               ? std::size_t(0)
+                               : pool.reserve(candidates.size() - 1);
+            auto const threads = helpers + 1;
+
+            while (scratch.size() < threads)
             {
-                cfilt[i] = dd[dd_start + i] * std::conj(cref[cref_start + i]);
+                scratch.emplace_back(std::make_unique<Scratch>());
             }
 
-            // Zero-fill the remainder, if any.
+            // Threads take candidates in chunks, downsampling each chunk as
+            // a batch; we'd rather have smaller batches than idle threads.
 
-            std::fill(cfilt.begin() + size, cfilt.end(), ZERO);
+            auto const chunk = std::clamp((candidates.size() + threads - 1) / threads,
+                                          std::size_t(1),
+                                          DOWNSAMPLE_BATCH);
 
-            // FFT to the frequency domain.
+            std::atomic<std::size_t> next    = 0;
+            std::atomic<std::size_t> skipped = 0;
 
-            fftwf_execute(plans[Plan::CF]);
+            // Chunks not started by the deadline are skipped; candidates
+            // are in priority order, so we lose the least valuable work.
 
-            // Apply the filter in the frequency domain.
+            auto const work = [&](Scratch & storage)
+            {
+                storage.downsampleTime = {};
+                storage.demodulateTime = {};
+                storage.bpTime         = {};
 
-            std::transform(cfilt.begin(),
-                           cfilt.end(),
-                           filter.begin(),
-                           cfilt.begin(),
-                           std::multiplies<>());
+                for (std::size_t first; (first = next.fetch_add(chunk)) < candidates.size();)
+                {
+                    auto const count = std::min(chunk, candidates.size() - first);
 
-            // Inverse FFT to return to the time domain.
+                    if (std::chrono::steady_clock::now() >= deadline)
+                    {
+                        skipped += count;
+                        continue;
+                    }
 
-            fftwf_execute(plans[Plan::CB]);
+                    {
+                        ScopedTimer timer(storage.downsampleTime);
+                        js8_downsample(storage, candidates.data() + first, count);
+                    }
 
-            // Subtract the reconstructed signal.
+                    ScopedTimer timer(storage.demodulateTime);
 
-            for (std::size_t i = 0; i < size; ++i)
+                    for (std::size_t b = 0; b < count; ++b)
+                    {
+                        results[first + b] = js8dec(storage,
+                                                    storage.cd0[b],
+                                                    candidates[first + b].freq,
+                                                    candidates[first + b].step);
+                    }
+                }
+            };
+
+            // Each helper takes the next scratch storage in line; we use
+            // the first, and wait for the helpers once we're out of work.
+
+            std::mutex               mutex;
+            std::condition_variable  finished;
+            std::size_t              running = helpers;
+            std::atomic<std::size_t> slot    = 1;
+
+            auto help = [&]
+            {
+                work(*scratch[slot++]);
+
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (--running == 0) finished.notify_all();
+            };
+
+            for (std::size_t i = 0; i < helpers; ++i) pool.post(help);
+
+            work(*scratch.front());
+
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&running] { return running == 0; });
+
+            using std::chrono::duration_cast;
+            using std::chrono::microseconds;
+
+            for (std::size_t i = 0; i < threads; ++i)
             {
-                dd[dd_start + i] -= 2.0f * std::real(cfilt[i] * cref[cref_start + i]);
+                stats.downsample += duration_cast<microseconds>(scratch[i]->downsampleTime);
+                stats.demodulate += duration_cast<microseconds>(scratch[i]->demodulateTime - scratch[i]->bpTime);
+                stats.bp         += duration_cast<microseconds>(scratch[i]->bpTime);
             }
+
+            for (auto const & result : results)
+            {
+                stats.bpIterations += result.bpIterations;
+                stats.bpFailures   += result.bpFailures;
+                stats.crcRejects   += result.crcRejects;
+            }
+
+            stats.skippedCandidates += static_cast<int>(skipped.load());
+
+            return results;
         }
 
     public:
@@ -2109,6 +2857,8 @@ namespace
 
             // Initialize Costas waveforms.
 
+            std::array<std::array<std::array<std::complex<float>, Mode::NDOWNSPS>, 7>, 3> csync;
+
             for (int i = 0; i < 7; ++i)
             {
                 float const dphia = TAU * Costas[0][i] / Mode::NDOWNSPS;
@@ -2121,9 +2871,9 @@ namespace
 
                 for (int j = 0; j < Mode::NDOWNSPS; ++j)
                 {
-                    csyncs[0][i][j] = std::polar(1.0f, phia);
-                    csyncs[1][i][j] = std::polar(1.0f, phib);
-                    csyncs[2][i][j] = std::polar(1.0f, phic);
+                    csync[0][i][j] = std::polar(1.0f, phia);
+                    csync[1][i][j] = std::polar(1.0f, phib);
+                    csync[2][i][j] = std::polar(1.0f, phic);
 
                     phia = std::fmod(phia + dphia, TAU);
                     phib = std::fmod(phib + dphib, TAU);
@@ -2131,64 +2881,117 @@ namespace
                 }
             }
 
-            // Compute a Hann-like window directly into the real part of the
-            // first NFILT + 1 elements in the filter, accumulating the sum
-            // as we go.
+            // Adjust the Costas waveforms by each of the frequency offsets
+            // that syncjs8d() will search, conjugating them for its use.
+            // For an offset of zero, the adjustment is the identity.
 
-            sum = 0.0f;
+            constexpr float BASE_DPHI = TAU * (1.0f / (12000.0f / Mode::NDOWN));
 
-            for (int j = -NFILT / 2; j <= NFILT / 2; ++j)
+            for (int ifr = -NFSRCH; ifr <= NFSRCH; ++ifr)
             {
-                int   const index = j + NFILT / 2;
-                float const value = std::pow(std::cos(pi * j / NFILT), 2);
-
-                filter[index].real(value);
-                sum             += value;
-            }
-
-            // Now that we've got the sum, create actual complex numbers using
-            // the normalized real values that we just populated and zero the
-            // rest of the filter.
+                std::array<std::complex<float>, Mode::NDOWNSPS> freqAdjust;
 
-            std::fill(std::transform(filter.begin(),
-                                     filter.begin() + NFILT + 1,
-                                     filter.begin(),
-                                     [sum](auto const value)
-                                     {
-                                         return std::complex<float>(value.real() / sum, 0.0f);
-                                     }),
-                      filter.end(),
-                      ZERO);
+                if (ifr != 0)
+                {
+                    float const dphi = BASE_DPHI * (ifr * 0.5f);
+                    float       phi  = 0.0f;
 
-            // Shift to position the window.
+                    // std::fmod() is almost like Fortran's mod(), but not quite;
+                    // Since the offset can be negative, we must ensure that phi
+                    // stays within [0, TAU), which Fortran's mod() handles by
+                    // itself.
 
-            std::rotate(filter.begin(),
-                        filter.begin() + NFILT / 2,
-                        filter.begin() + NFILT + 1);
-
-            // Transform the filter into the frequency domain.
+                    for (int i = 0; i < Mode::NDOWNSPS; ++i)
+                    {
+                        freqAdjust[i] = std::polar(1.0f, phi);
+                        if (phi = std::fmod(phi + dphi, TAU);
+                            phi < 0.0f)
+                        {
+                            phi += TAU;
+                        }
+                    }
+                }
+                else
+                {
+                    freqAdjust.fill(std::complex<float>{1.0f, 0.0f});
+                }
 
-            fftwf_plan fftw_plan;
-            {
-                std::lock_guard<std::mutex> lock(fftw_mutex);
+                for (int i = 0; i < 3; ++i)
+                {
+                    for (int j = 0; j < 7; ++j)
+                    {
+                        for (int k = 0; k < Mode::NDOWNSPS; ++k)
+                        {
+                            csyncs[ifr + NFSRCH][i][j][k] = std::conj(freqAdjust[k] * csync[i][j][k]);
+                        }
+                    }
+                }
+            }
 
-                fftw_plan = fftwf_plan_dft_1d(Mode::NMAX,
-                                              reinterpret_cast<fftwf_complex *>(filter.data()),
-                                              reinterpret_cast<fftwf_complex *>(filter.data()),
-                                              FFTW_FORWARD,
-                                              FFTW_ESTIMATE_PATIENT);
+            // Initialize tone waveforms for a single symbol; every tone
+            // completes a whole number of cycles over a symbol.
 
-                if (!fftw_plan)
+            for (int m = 0; m < NROWS; ++m)
+            {
+                for (int n = 0; n < Mode::NSPS; ++n)
                 {
-                    throw std::runtime_error("Failed to create FFT plan");
+                    ctones[m][n] = std::polar(1.0f, TAU * ((m * n) % Mode::NSPS) / Mode::NSPS);
                 }
             }
 
-            fftwf_execute(fftw_plan);
+            // Compute a Hann-like window directly into the real part of the
+            // first NFILT + 1 elements in the filter, accumulating the sum
+            // as we go.
+
+            sum = 0.0f;
 
+            for (int j = -NFILT / 2; j <= NFILT / 2; ++j)
             {
-                std::lock_guard<std::mutex> lock(fftw_mutex);
-                fftwf_destroy_plan(fftw_plan);
+                int   const index = j + NFILT / 2;
+                float const value = std::pow(std::cos(pi * j / NFILT), 2);
+
+                filter[index].real(value);
+                sum             += value;
+            }
+
+            // Now that we've got the sum, create actual complex numbers using
+            // the normalized real values that we just populated and zero the
+            // rest of the filter.
+
+            std::fill(std::transform(filter.begin(),
+                                     filter.begin() + NFILT + 1,
+                                     filter.begin(),
+                                     [sum](auto const value)
+                                     {
+                                         return std::complex<float>(value.real() / sum, 0.0f);
+                                     }),
+                      filter.end(),
+                      ZERO);
+
+            // Shift to position the window.
+
+            std::rotate(filter.begin(),
+                        filter.begin() + NFILT / 2,
+                        filter.begin() + NFILT + 1);
+
+            // Transform the filter into the frequency domain; this is the
+            // same problem as the CF plan solves, so it'll share its wisdom.
+
+            using Problem = FFTW::Problem;
+            using Kind    = FFTW::Problem::Kind;
+
+            {
+                auto const planStart = std::chrono::steady_clock::now();
+
+                FFTW::Plan const plan(Problem{Kind::C2C, NSUB, FFTW_FORWARD},
+                                      filter.data(),
+                                      filter.data());
+
+                if (!plan) throw std::runtime_error("Failed to create FFT plan");
+
+                planTime += std::chrono::steady_clock::now() - planStart;
+
+                fftwf_execute(plan);
             }
 
             // Normalize the frequency domain representation.
@@ -2196,7 +2999,7 @@ namespace
             std::transform(filter.begin(),
                            filter.end(),
                            filter.begin(),
-                           [factor = 1.0f / Mode::NMAX](auto value)
+                           [factor = 1.0f / NSUB](auto value)
                            {
                                return value * factor;
                            });
@@ -2204,96 +3007,479 @@ namespace
             // The rest of our FFT plans are always the same size and operate on the
             // same data, so we can reuse them as long as we're alive.
 
-            std::lock_guard<std::mutex> lock(fftw_mutex);
+            cacheKeys.resize(NSPECTRA);
+            cachePower.resize(NSPECTRA * Mode::NSPS);
+
+            auto & cd0   = scratch.emplace_back(std::make_unique<Scratch>())->cd0;
+            auto & csymb = scratch.front()->csymb;
 
-            plans[Plan::DS] = fftwf_plan_dft_1d(Mode::NDFFT2,
-                                                reinterpret_cast<fftwf_complex *>(cd0.data()),
-                                                reinterpret_cast<fftwf_complex *>(cd0.data()),
-                                                FFTW_BACKWARD,
-                                                FFTW_ESTIMATE_PATIENT);
+            auto const planStart = std::chrono::steady_clock::now();
 
-            plans[Plan::BB] = fftwf_plan_dft_r2c_1d(Mode::NDFFT1,
-                                                    reinterpret_cast<float         *>(ds_cx.data()),
-                                                    reinterpret_cast<fftwf_complex *>(ds_cx.data()),
-                                                    FFTW_ESTIMATE_PATIENT);
+            plans[Plan::DS] = FFTW::Plan(Problem{Kind::C2C, Mode::NDFFT2, FFTW_BACKWARD},
+                                         cd0.front().data(),
+                                         cd0.front().data());
 
-            plans[Plan::CF] = fftwf_plan_dft_1d(Mode::NMAX,
-                                                reinterpret_cast<fftwf_complex *>(cfilt.data()),
-                                                reinterpret_cast<fftwf_complex *>(cfilt.data()),
-                                                FFTW_FORWARD,
-                                                FFTW_ESTIMATE_PATIENT);
+            plans[Plan::DB] = FFTW::Plan(Problem{Kind::C2C, Mode::NDFFT2, FFTW_BACKWARD, DOWNSAMPLE_BATCH, NP, NP},
+                                         cd0.data(),
+                                         cd0.data());
 
-            plans[Plan::CB] = fftwf_plan_dft_1d(Mode::NMAX,
-                                                reinterpret_cast<fftwf_complex *>(cfilt.data()),
-                                                reinterpret_cast<fftwf_complex *>(cfilt.data()),
-                                                FFTW_BACKWARD,
-                                                FFTW_ESTIMATE_PATIENT);
+            plans[Plan::BB] = FFTW::Plan(Problem{Kind::R2C, Mode::NDFFT1},
+                                         ds_cx.data(),
+                                         ds_cx.data());
 
-            plans[Plan::SD] = fftwf_plan_dft_r2c_1d(Mode::NFFT1,
-                                                    reinterpret_cast<float         *>(sd.data()),
-                                                    reinterpret_cast<fftwf_complex *>(sd.data()),
-                                                    FFTW_ESTIMATE_PATIENT);
+            plans[Plan::CF] = FFTW::Plan(Problem{Kind::C2C, NSUB, FFTW_FORWARD},
+                                         cfilt.data(),
+                                         cfilt.data());
 
-            plans[Plan::CS] = fftwf_plan_dft_1d(Mode::NDOWNSPS,
-                                                reinterpret_cast<fftwf_complex *>(csymb.data()),
-                                                reinterpret_cast<fftwf_complex *>(csymb.data()),
-                                                FFTW_FORWARD,
-                                                FFTW_ESTIMATE_PATIENT);
+            plans[Plan::CB] = FFTW::Plan(Problem{Kind::C2C, NSUB, FFTW_BACKWARD},
+                                         cfilt.data(),
+                                         cfilt.data());
 
-            for (auto plan : plans)
+            plans[Plan::SD] = FFTW::Plan(Problem{Kind::R2C, Mode::NFFT1, FFTW_FORWARD, SPECTRA_BATCH, Mode::NFFT1, Mode::NFFT1 / 2 + 1, false},
+                                         sd_in.data(),
+                                         sd.data());
+
+            plans[Plan::CS] = FFTW::Plan(Problem{Kind::C2C, Mode::NDOWNSPS, FFTW_FORWARD, NN, Mode::NDOWNSPS, Mode::NDOWNSPS},
+                                         csymb.data(),
+                                         csymb.data());
+
+            for (auto const & plan : plans)
             {
                 if (!plan) throw std::runtime_error("Failed to create FFT plan");
             }
+
+            planTime += std::chrono::steady_clock::now() - planStart;
         }
 
-        // Decode entry point.
+        // Select the check node update rule of belief propagation; applies
+        // to subsequent decodes.
+
+        void
+        setBPVariant(BPVariant const variant) noexcept
+        {
+            bpVariant = variant;
+        }
+
+        // Select exact sync search; applies to subsequent decodes. When set,
+        // syncjs8() sums tone power in the same order as the Fortran version
+        // did, producing identical results. Otherwise, the sum over all tones
+        // of each bin is computed once for each time step and shared by every
+        // lag, which is much faster, but differs in the last bits of the sync
+        // metric.
+
+        void
+        setSyncExact(bool const exact) noexcept
+        {
+            syncExact = exact;
+        }
+
+        // Introspection; time spent creating our FFT plans, and the number of
+        // bytes of memory we're holding, exclusive of FFTW's own allocations
+        // for the plans.
+
+        std::chrono::nanoseconds
+        planDuration() const noexcept
+        {
+            return planTime;
+        }
 
         std::size_t
-        operator()(struct dec_data const & data,
-                   int             const   kpos,
-                   int             const   ksz,
-                   JS8::Event::Emitter     emitEvent)
+        residentBytes() const noexcept
         {
-            // Copy the relevant frames for decoding
+            auto const bytes = [](auto const & vector)
+            {
+                return vector.capacity() * sizeof(typename std::decay_t<decltype(vector)>::value_type);
+            };
 
-            auto const pos = std::max(0, kpos);
-            auto const sz  = std::max(0, ksz);
+            return sizeof(*this)
+                 + scratch.size() * sizeof(Scratch)
+                 + bytes(scratch)
+                 + bytes(results)
+                 + bytes(cref)
+                 + bytes(colsum)
+                 + bytes(tsum)
+                 + bytes(smax)
+                 + bytes(jmax)
+                 + bytes(sync)
+                 + bytes(rank)
+                 + bytes(order)
+                 + erased.capacity() / 8
+                 + bytes(candidates)
+                 + bytes(pending)
+                 + bytes(subtractions)
+                 + bytes(known)
+                 + bytes(cacheKeys)
+                 + bytes(cachePower);
+        }
 
-            assert(sz <= Mode::NMAX);
+        // Check the tables with which genjs8refsig() and syncjs8d() work
+        // against direct computation, in double precision, of what they
+        // stand in for, over pseudorandom tones, base frequencies, and
+        // downsampled data. Returns the largest error of each, relative to
+        // the magnitude of the directly computed value.
+
+        std::pair<double, double>
+        checkTables()
+        {
+            constexpr double TWO_PI = 2.0 * std::numbers::pi;
+
+            // Phase of a number of cycles, reduced to a single cycle so
+            // as to keep full precision.
+
+            auto const phase = [](double const cycles)
+            {
+                return TWO_PI * (cycles - std::floor(cycles));
+            };
+
+            std::mt19937                           rng(1);
+            std::uniform_int_distribution<>        tone(0, NROWS - 1);
+            std::uniform_real_distribution<double> frequency(100.0, 4900.0);
+            std::normal_distribution<float>        noise;
+
+            double referenceError = 0.0;
+            double syncError      = 0.0;
+
+            for (int trial = 0; trial < 4; ++trial)
+            {
+                // Reference signal, of continuous phase across symbols.
+
+                std::array<int, NN> itone;
+
+                for (auto & t : itone) t = tone(rng);
+
+                auto const   f0        = static_cast<float>(frequency(rng));
+                auto const & reference = genjs8refsig(itone, f0);
+
+                for (int i = 0; i < NN; ++i)
+                {
+                    for (int n = 0; n < Mode::NSPS; ++n)
+                    {
+                        auto const k      = i * Mode::NSPS + n;
+                        auto const cycles = static_cast<double>(f0) * k / 12000.0
+                                          + static_cast<double>(itone[i]) * n / Mode::NSPS;
+                        auto const exact  = std::polar(1.0, phase(cycles));
+
+                        referenceError = std::max(referenceError, std::abs(std::complex<double>(reference[k]) - exact));
+                    }
+                }
+
+                // Fine sync, over every frequency offset searched, at time
+                // offsets either side of zero, so that some Costas symbols
+                // lie outside of the data.
+
+                Downsampled cd0;
+
+                for (auto & sample : cd0) sample = {noise(rng), noise(rng)};
+
+                int const i0 = (trial - 1) * Mode::NDOWNSPS / 2;
+
+                for (int ifr = -NFSRCH; ifr <= NFSRCH; ++ifr)
+                {
+                    double exact = 0.0;
+
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        for (int j = 0; j < 7; ++j)
+                        {
+                            auto const offset = 36 * i * Mode::NDOWNSPS + i0 + j * Mode::NDOWNSPS;
+
+                            if (offset < 0 || offset + Mode::NDOWNSPS > Mode::NP2) continue;
+
+                            std::complex<double> sum;
+
+                            for (int k = 0; k < Mode::NDOWNSPS; ++k)
+                            {
+                                auto const cycles = ifr * 0.5 * k / (12000.0 / Mode::NDOWN)
+                                                  + static_cast<double>(Costas[i][j]) * k / Mode::NDOWNSPS;
+
+                                sum += std::complex<double>(cd0[offset + k]) * std::polar(1.0, -phase(cycles));
+                            }
+
+                            exact += std::norm(sum);
+                        }
+                    }
+
+                    syncError = std::max(syncError, std::abs(syncjs8d(cd0, i0, ifr) - exact) / exact);
+                }
+            }
+
+            return {referenceError, syncError};
+        }
+
+        // Check the sync search against the Fortran version's, over random
+        // symbol spectra spanning the widest frequency range searched, both
+        // in exact mode, and otherwise. Returns the largest error of the sync
+        // metric at the best lag found, relative to that of the Fortran
+        // version, for each, and the number of bins at which exact mode found
+        // a different lag. Exact mode should differ in neither respect.
+
+        std::tuple<double, double, int>
+        checkSync()
+        {
+            std::mt19937                         rng(1);
+            std::exponential_distribution<float> power;
 
-            if (data.params.syncStats) emitEvent(JS8::Event::SyncStart{pos, sz});
+            for (auto & row : s)
+            {
+                for (auto & value : row) value = power(rng);
+            }
+
+            int  const ia   = 0;
+            int  const ib   = static_cast<int>(std::round(4910 / Mode::DF));
+            auto const bins = static_cast<std::size_t>(ib - ia + 1);
+
+            // The Fortran version; every lag of every bin sums the tones for
+            // itself, and each variant sums its Costas arrays afresh.
 
-            auto const ddCopy = [](auto const begin,
-                                   auto const end,
-                                   auto const to)
+            std::vector<float> baseline(bins);
+            std::vector<int>   lags    (bins);
+
+            for (std::size_t i = 0; i < bins; ++i)
             {
-                std::transform(begin, end, to, [](auto const value)
+                float max_value = -std::numeric_limits<float>::infinity();
+                int   max_index = -Mode::JZ;
+
+                for (int j = -Mode::JZ; j <= Mode::JZ; ++j)
                 {
-                    return static_cast<float>(value);
-                });
+                    std::array<std::array<float, 3>, 2> t{};
+
+                    for (int p = 0; p < 3; ++p)
+                    {
+                        for (int n = 0; n < 7; ++n)
+                        {
+                            int const offset = j + Mode::JSTRT + NSSY * n + p * 36 * NSSY;
+
+                            if (offset < 0 || offset >= Mode::NHSYM) continue;
+
+                            auto const row = s[offset].data() + ia + i;
+
+                            t[0][p] += row[NFOS * Costas[p][n]];
+
+                            for (int freq = 0; freq < 7; ++freq) t[1][p] += row[NFOS * freq];
+                        }
+                    }
+
+                    auto const compute_sync = [&t](int const start,
+                                                   int const end)
+                    {
+                        float tx = 0.0f;
+                        float t0 = 0.0f;
+
+                        for (int p = start; p <= end; ++p)
+                        {
+                            tx += t[0][p];
+                            t0 += t[1][p];
+                        }
+
+                        return tx / ((t0 - tx) / 6.0f);
+                    };
+
+                    if (auto const sync_value = std::max({
+                            compute_sync(0, 2),
+                            compute_sync(0, 1),
+                            compute_sync(1, 2)
+                        }); sync_value > max_value)
+                    {
+                        max_value = sync_value;
+                        max_index = j;
+                    }
+                }
+
+                baseline[i] = max_value;
+                lags    [i] = max_index;
+            }
+
+            auto const error = [&]
+            {
+                double result = 0.0;
+
+                for (std::size_t i = 0; i < bins; ++i)
+                {
+                    result = std::max(result, std::abs(static_cast<double>(smax[i]) - baseline[i]) / std::abs(baseline[i]));
+                }
+
+                return result;
             };
 
-            dd.fill(0.0f);
+            auto const exact = syncExact;
+
+            syncExact = true;
+            searchSync(ia, bins);
 
-            if ((JS8_RX_SAMPLE_SIZE - pos) < sz)
+            auto const exactError = error();
+            int        lagErrors  = 0;
+
+            for (std::size_t i = 0; i < bins; ++i)
             {
-                // Wrap case; split into two parts.
+                if (jmax[i] != lags[i]) ++lagErrors;
+            }
+
+            syncExact = false;
+            searchSync(ia, bins);
+
+            auto const fastError = error();
 
-                int const firstsize  = JS8_RX_SAMPLE_SIZE - pos;
-                int const secondsize = sz - firstsize;
+            syncExact = exact;
 
-                ddCopy(std::begin(data.d2) + pos, std::begin(data.d2) + pos + firstsize,  dd.begin());
-                ddCopy(std::begin(data.d2),       std::begin(data.d2) +       secondsize, dd.begin() + firstsize);
+            return {exactError, fastError, lagErrors};
+        }
+
+        // If the buffer contents have been cleared since we last ran,
+        // nothing we know of them is valid. Realigning the buffer doesn't
+        // move its contents, and we work in terms of buffer indices, so
+        // what we know survives that.
+
+        void
+        validate(int const epoch)
+        {
+            if (cacheEpoch != epoch)
+            {
+                std::fill(cacheKeys.begin(), cacheKeys.end(), CacheKey{});
+                known.clear();
+                primedIndex    = -1;
+                cacheEpoch     = epoch;
             }
-            else
+        }
+
+        // Get a head start on a decode of a window, of which the snapshot is
+        // the portion that's been captured so far, by computing the symbol
+        // spectra that are complete within it; sync will then find them in
+        // the cache. Spectra computed for the same window by earlier calls
+        // aren't computed again.
+
+        void
+        prime(JS8::Snapshot const & snapshot,
+              int           const   epoch)
+        {
+            validate(epoch);
+
+            auto const pos = snapshot.index();
+            auto const sz  = snapshot.size();
+
+            if (pos < 0 || sz < Mode::NFFT1 || sz > Mode::NMAX) return;
+
+            if (pos != primedIndex)
+            {
+                primedIndex = pos;
+                primedCount    = 0;
+            }
+
+            auto const count = std::min(NSPECTRA, (sz - Mode::NFFT1) / Mode::NSTEP + 1);
+
+            if (count <= primedCount) return;
+
+            plans.refresh();
+            snapshot.copy(dd.data());
+
+            computeSpectra(pos, primedCount, count);
+
+            primedCount = count;
+        }
+
+        // Decode entry point; events are reported via the supplied emitter,
+        // which is invoked with each event as it occurs. Effort is scaled
+        // back as required to finish by the deadline; work skipped to do
+        // so is reported in the decode statistics.
+
+        template <typename Emitter>
+        std::size_t
+        operator()(DecodeParams                          const & params,
+                   JS8::Snapshot                         const & snapshot,
+                   std::chrono::steady_clock::time_point const   deadline,
+                   Emitter                                    && emitEvent)
+        {
+            using Clock = std::chrono::steady_clock;
+
+            // Copy the relevant frames for decoding from the snapshot,
+            // zero-filling the remainder.
+
+            auto const pos = snapshot.index();
+            auto const sz  = snapshot.size();
+
+            assert(sz <= Mode::NMAX);
+
+            // Instrumentation of this run, reported when we're done.
+
+            auto const      startTime = Clock::now();
+            Clock::duration syncTime{};
+            Clock::duration subtractTime{};
+
+            spectraTime = {};
+
+            JS8::Event::DecodeStats stats{};
+
+            stats.mode = Mode::NSUBMODE;
+
+            if (params.syncStats) emitEvent(JS8::Event::SyncStart{snapshot.position(), sz});
+
+            snapshot.copy(dd.data());
+            std::fill(dd.begin() + sz, dd.end(), 0.0f);
+
+            // Swap in any better FFT plans that the planning service has come
+            // up with since we last ran.
+
+            plans.refresh();
+
+            validate(params.epoch);
+
+            // Signals that we know of are valid only for as long as we're
+            // decoding windows that contain them; once we've moved on to
+            // another period, or if we've no idea where in the ring buffer
+            // our samples came from, we forget them.
+
+            auto const offset = [pos](int const start)
             {
-                // Non-wrapping case; copy directly.
+                return (start - pos + JS8_RX_SAMPLE_SIZE) % JS8_RX_SAMPLE_SIZE;
+            };
 
-                ddCopy(std::begin(data.d2) + pos, std::begin(data.d2) + pos + sz, dd.begin());
+            if (pos < 0)
+            {
+                known.clear();
+            }
+            else
+            {
+                std::erase_if(known, [&](Known const & entry) { return offset(entry.start) >= sz; });
+                for (auto & entry : known) entry.matched = 0;
             }
 
+            // Signals decoded by this run are remembered for later runs, but
+            // within this one, are handled just as they'd otherwise be.
+
+            auto const earlier = known.size();
+
             Decode::Map decodes;
 
+            // Candidates are processed in order of distance from nfqso, those
+            // close to it first. Should we not have time for all of them, we
+            // keep those close to nfqso, then those with the strongest sync.
+            // Both orders are total, ties being broken by frequency and then
+            // time, so an unstable sort is as deterministic as a stable one.
+
+            auto const order = [nfqso = params.nfqso](auto const & a,
+                                                      auto const & b)
+            {
+                auto const a_dist = std::abs(a.freq - nfqso);
+                auto const b_dist = std::abs(b.freq - nfqso);
+
+                if (a_dist < 10.0f && b_dist >= 10.0f) return true;
+                if (b_dist < 10.0f && a_dist >= 10.0f) return false;
+
+                return std::tie(a_dist, a.freq, a.step) <
+                       std::tie(b_dist, b.freq, b.step);
+            };
+
+            auto const priority = [&order, nfqso = params.nfqso](auto const & a,
+                                                                 auto const & b)
+            {
+                bool const a_close = std::abs(a.freq - nfqso) < 10.0f;
+                bool const b_close = std::abs(b.freq - nfqso) < 10.0f;
+
+                if (a_close != b_close) return a_close;
+                if (a.sync  != b.sync)  return a.sync > b.sync;
+
+                return order(a, b);
+            };
+
             for (int ipass = 1; ipass <= 3; ++ipass)
             {
                 // Determine if there's anything worth considering in the signal.
@@ -2301,76 +3487,200 @@ namespace
                 // yield more results. If we do have some candidates, sort them
                 // by frequency, but put any that are close to nfqso up front.
 
-                auto candidates = syncjs8(data.params.nfa,
-                                          data.params.nfb);
+                auto const syncStart = Clock::now();
+
+                auto & candidates = [&]() -> auto &
+                {
+                    ScopedTimer timer(syncTime);
+                    return syncjs8(params.nfa,
+                                   params.nfb,
+                                   ipass == 1 ? pos : -1);
+                }();
+
+                estimate(syncCost, Clock::now() - syncStart);
+
+                stats.passes                = ipass;
+                stats.candidates[ipass - 1] = static_cast<int>(candidates.size());
 
                 if (candidates.empty()) break;
 
                 std::sort(candidates.begin(),
                           candidates.end(),
-                          [nfqso = data.params.nfqso](auto const & a,
-                                                      auto const & b)
-                          {
-                            auto const a_dist = std::abs(a.freq - nfqso);
-                            auto const b_dist = std::abs(b.freq - nfqso);
+                          order);
+
+                // Candidates that are signals we already know of need not be
+                // decoded again. On the pass in which we first find them,
+                // they're subtracted, as if we had, so that later passes can
+                // see beneath them; after that, they're what's left of that.
+
+                if (earlier)
+                {
+                    std::erase_if(candidates, [&](Sync const & candidate)
+                    {
+                        auto const start = (candidate.step + Mode::ASTART) * 12000.0f;
 
-                            if (a_dist < 10.0f && b_dist >= 10.0f) return true;
-                            if (b_dist < 10.0f && a_dist >= 10.0f) return false;
+                        for (auto & entry : std::span(known).first(earlier))
+                        {
+                            if (std::abs(entry.f1 - candidate.freq)   <= KNOWN_FREQUENCY &&
+                                std::abs(offset(entry.start) - start) <= KNOWN_SAMPLES)
+                            {
+                                if (!entry.matched) entry.matched = ipass;
+                                ++stats.knownCandidates;
+                                return true;
+                            }
+                        }
 
-                            return std::tie(a_dist, a.freq) <
-                                   std::tie(b_dist, b.freq);
-                          });
+                        return false;
+                    });
+                }
 
                 // Recompute the baseband signal; subtraction during the last
                 // pass might have changed the landscape.
 
                 computeBasebandFFT();
 
+                // Fit the work to the time remaining, if we've an idea of what
+                // it'll cost; limit belief propagation first, then drop the
+                // lowest-priority candidates, keeping the rest in order.
+
+                llrPasses = FULL_LLR_PASSES;
+
+                if (auto const [full, reduced] = candidateCost;
+                    deadline != Clock::time_point::max() && full != full.zero())
+                {
+                    auto const remaining = std::max(deadline - Clock::now(), Clock::duration::zero());
+
+                    if (full * static_cast<Clock::rep>(candidates.size()) > remaining)
+                    {
+                        llrPasses = REDUCED_LLR_PASSES;
+                        ++stats.reducedPasses;
+
+                        auto const cost       = reduced != reduced.zero() ? reduced : full;
+                        auto const affordable = static_cast<std::size_t>(remaining / cost);
+
+                        if (affordable < candidates.size())
+                        {
+                            stats.skippedCandidates += static_cast<int>(candidates.size() - affordable);
+
+                            std::sort(candidates.begin(),
+                                      candidates.end(),
+                                      priority);
+                            candidates.erase(candidates.begin() + affordable,
+                                             candidates.end());
+                            std::sort(candidates.begin(),
+                                      candidates.end(),
+                                      order);
+                        }
+                    }
+                }
+
                 bool const subtract = ipass < 3;
                 bool       improved = false;
 
-                for (auto [f1, xdt, sync] : candidates)
+                // Signals to subtract once we've processed all candidates.
+
+                subtractions.clear();
+
+                // Known signals first found by this pass go first, in the
+                // order in which they were decoded.
+
+                for (auto const & entry : std::span(known).first(earlier))
                 {
-                    float xsnr        =  0.0f;
-                    int   nharderrors = -1;
-
-                    if (auto decode = js8dec(data.params.syncStats,
-                                             subtract,
-                                             f1,
-                                             xdt,
-                                             nharderrors,
-                                             xsnr,
-                                             emitEvent))
-                    {
-                        // We don't need to be emitting duplicate events for something
-                        // that's effectively the same SNR as a previous event.
+                    if (entry.matched != ipass) continue;
 
-                        auto const snr = static_cast<int>(std::round(xsnr));
+                    auto const xdt = offset(entry.start) / 12000.0f;
 
-                        // If this decode is new, or it's a duplicate with a better SNR
-                        // than what we had before, then our situation has improved and
-                        // we must announce that we've had some success.
+                    if (params.syncStats) emitEvent(JS8::Event::SyncState{JS8::Event::SyncState::Type::DECODED,
+                                                                               Mode::NSUBMODE,
+                                                                               entry.f1,
+                                                                               xdt,
+                                                                               {.decoded = entry.sync}});
 
-                        if (auto [it, inserted] = decodes.try_emplace(std::move(*decode), snr);
-                                      inserted || it->second < snr)
-                        {
-                            improved = true;
+                    if (subtract) subtractions.emplace_back(entry.itone, entry.f1, xdt);
+                    improved = true;
+                }
 
-                            // Update the SNR if this is an improved decode.
+                // Demodulate the candidates, then process the results in
+                // candidate order; events and subtractions must occur in
+                // the same order as they would have in a serial run.
 
-                            if (!inserted) it->second = snr;
+                auto const demodStart = Clock::now();
+                auto const skipped    = stats.skippedCandidates;
+                auto     & demods     = demodulate(candidates, deadline, stats);
 
-                            // Emit decoded events on new or improved decodes.
+                if (auto const demodulated = candidates.size() - (stats.skippedCandidates - skipped))
+                {
+                    estimate(candidateCost[llrPasses == FULL_LLR_PASSES ? 0 : 1],
+                             (Clock::now() - demodStart) / demodulated);
+                }
 
-                            emitEvent(JS8::Event::Decoded{data.params.nutc,
-                                                          snr,
-                                                          xdt - Mode::ASTART,
-                                                          f1,
-                                                          it->first.data,
-                                                          it->first.type,
-                                                          1.0f - nharderrors / 60.0f,
-                                                          Mode::NSUBMODE});
-                        }
+                for (auto & [f1, xdt, sync, xsnr, nsync, nharderrors, decode, itone, bpIterations, bpFailures, crcRejects] : demods)
+                {
+                    // Nothing to see here if this one didn't pass the sync
+                    // quality check.
+
+                    if (!nsync) continue;
+
+                    if (params.syncStats) emitEvent(JS8::Event::SyncState{JS8::Event::SyncState::Type::CANDIDATE,
+                                                                               Mode::NSUBMODE,
+                                                                               f1,
+                                                                               xdt,
+                                                                               {.candidate = nsync}});
+                    if (!decode) continue;
+
+                    if (params.syncStats) emitEvent(JS8::Event::SyncState{JS8::Event::SyncState::Type::DECODED,
+                                                                               Mode::NSUBMODE,
+                                                                               f1,
+                                                                               xdt,
+                                                                               {.decoded = sync}});
+
+                    // Note signal for subtraction if needed.
+
+                    if (subtract) subtractions.emplace_back(itone, f1, xdt);
+
+                    // Remember where it was, so that later runs over this
+                    // window needn't decode it again.
+
+                    if (pos >= 0) known.push_back({(pos + static_cast<int>(std::lround(xdt * 12000.0f)) + JS8_RX_SAMPLE_SIZE) % JS8_RX_SAMPLE_SIZE,
+                                                   f1,
+                                                   sync,
+                                                   itone,
+                                                   0});
+
+                    // We don't need to be emitting duplicate events for something
+                    // that's effectively the same SNR as a previous event.
+
+                    auto const snr = static_cast<int>(std::round(xsnr));
+
+                    // If this decode is new, or it's a duplicate with a better SNR
+                    // than what we had before, then our situation has improved and
+                    // we must announce that we've had some success.
+
+                    if (auto [it, inserted] = decodes.try_emplace(std::move(*decode), snr);
+                                  inserted || it->second < snr)
+                    {
+                        improved = true;
+
+                        // Update the SNR if this is an improved decode.
+
+                        if (!inserted) it->second = snr;
+
+                        // Emit decoded events on new or improved decodes.
+
+                        JS8::Event::Decoded decoded{params.nutc,
+                                                    snr,
+                                                    xdt - Mode::ASTART,
+                                                    f1,
+                                                    {},
+                                                    it->first.type,
+                                                    1.0f - nharderrors / 60.0f,
+                                                    Mode::NSUBMODE};
+
+                        std::copy_n(it->first.data.begin(),
+                                    decoded.data.size(),
+                                    decoded.data.begin());
+
+                        emitEvent(decoded);
                     }
                 }
 
@@ -2378,8 +3688,49 @@ namespace
                 // point in trying any remaining passes.
 
                 if (!improved) break;
+
+                // Subtraction serves only the next pass; if there's no time
+                // for another sync, we're done.
+
+                if (subtract && Clock::now() + syncCost > deadline)
+                {
+                    stats.skippedPasses = 3 - ipass;
+                    break;
+                }
+
+                // Subtract the decoded signals in the order in which they were
+                // decoded; the next pass will recompute the baseband signal
+                // with all of them having been removed.
+
+                ScopedTimer timer(subtractTime);
+
+                for (auto const & [itone, f1, xdt] : subtractions)
+                {
+                    subtractjs8(genjs8refsig(itone, f1), xdt);
+                }
             }
 
+            // Known signals that no pass found are gone, or too weak now for
+            // sync to find; forget them, so that a later run can decode them
+            // afresh if they come back.
+
+            known.erase(std::remove_if(known.begin(),
+                                       known.begin() + earlier,
+                                       [](Known const & entry) { return !entry.matched; }),
+                        known.begin() + earlier);
+
+            // Report how the time went.
+
+            using std::chrono::duration_cast;
+            using std::chrono::microseconds;
+
+            stats.sync     = duration_cast<microseconds>(syncTime);
+            stats.spectra  = duration_cast<microseconds>(spectraTime);
+            stats.subtract = duration_cast<microseconds>(subtractTime);
+            stats.total    = duration_cast<microseconds>(Clock::now() - startTime);
+
+            emitEvent(stats);
+
             // Let the caller know how many unique decodes we discovered, if any.
 
             return decodes.size();
@@ -2393,7 +3744,9 @@ namespace
     template class DecodeMode<ModeB>;
     template class DecodeMode<ModeC>;
     template class DecodeMode<ModeE>;
+#if JS8_ENABLE_JS8I
     template class DecodeMode<ModeI>;
+#endif
 }
 
 /******************************************************************************/
@@ -2406,138 +3759,414 @@ namespace JS8
     {
         Q_OBJECT
 
-        // Initialization of the decoders, in that they're heavy with
-        // FFT plan creations, is non-trivial, so a handle-body class
-        // to avoid initializing them on the main thread.
+        // Resource usage of each of the decode strategies, maintained
+        // by the implementation and read by the owning Decoder.
+
+        struct Footprints
+        {
+            mutable std::mutex     mutex;
+            std::vector<Footprint> entries;
+        };
+
+        // Decoding runs are driven from our thread, each mode decoding on
+        // a thread of the decode pool, or on ours should none be free. A
+        // handle-body class holds the decoders, each of which is created
+        // when its submode is first primed, on our thread, or scheduled
+        // for decoding, on whichever thread decodes it. They're heavy with
+        // FFT plans and large buffers, so we don't want to create any that
+        // we're not going to use.
+        //
+        // Note that creating a decoder creates its plans, which serializes
+        // on fftw_mutex with all other planning, including the background
+        // measurement of better plans; a decoder first created by a run
+        // can be held up for the remainder of a measurement in progress,
+        // and its mode's deadline runs all the while.
 
         class Impl
         {
-            // To avoid data races, decode data is referenced here but is
-            // actually located in the Worker that instantiates us, as it
-            // must be possible to copy data for us before we're ready to
-            // process it.
+            // Decode parameters and snapshots are referenced here but are
+            // actually located in the Worker that instantiates us; it hands
+            // them over on our thread, by value, prior to each run, so they
+            // don't change while any of the modes are reading them.
 
-            struct dec_data & m_data;
+            DecodeParams            const & m_params;
+            std::array<Snapshot, 5>       & m_snapshots;
+            std::atomic<int>        const & m_submodes;
+            Footprints                    & m_footprints;
 
-            // Mode-specific decode strategy; we'll instantiate one of
-            // these for each of the 5 modes; this class is an aggregate
-            // of the 5 modes.
+            // Mode-specific decode strategy; we'll have an entry for each
+            // of the modes that are compiled in, the strategy for which is
+            // created on first use, and released when the mode is disabled.
 
             struct DecodeEntry
             {
                 std::variant<
-                    DecodeMode<ModeA>,
-                    DecodeMode<ModeB>,
-                    DecodeMode<ModeC>,
-                    DecodeMode<ModeE>,
-                    DecodeMode<ModeI>
-                >     decode;
-                int   mode;
-                int & kpos;
-                int & ksz;
+#if JS8_ENABLE_JS8I
+                    std::unique_ptr<DecodeMode<ModeI>>,
+#endif
+                    std::unique_ptr<DecodeMode<ModeE>>,
+                    std::unique_ptr<DecodeMode<ModeC>>,
+                    std::unique_ptr<DecodeMode<ModeB>>,
+                    std::unique_ptr<DecodeMode<ModeA>>
+                >                           decode;
+                int                         mode;
+                std::size_t                 shift;
+                std::chrono::seconds        period;
+                std::vector<Event::Variant> events;
 
                 template <typename DecodeModeType>
                 DecodeEntry(std::in_place_type_t<DecodeModeType>,
-                            int   mode,
-                            int & kpos,
-                            int & ksz)
-                    : decode(std::in_place_type<DecodeModeType>)
-                    , mode  (mode)
-                    , kpos  (kpos)
-                    , ksz   (ksz)
+                            std::size_t          shift,
+                            std::chrono::seconds period)
+                    : decode(std::in_place_type<std::unique_ptr<DecodeModeType>>)
+                    , mode  (1 << shift)
+                    , shift (shift)
+                    , period(period)
                     {}
+
+                // Obtain the strategy, creating it if necessary; called on
+                // the thread that's about to use it.
+
+                void create()
+                {
+                    std::visit([](auto & decode)
+                    {
+                        using T = typename std::decay_t<decltype(decode)>::element_type;
+                        if (!decode) decode = std::make_unique<T>();
+                    }, decode);
+                }
+
+                // Release the strategy, if we have it.
+
+                void release()
+                {
+                    std::visit([](auto & decode) { decode.reset(); }, decode);
+                }
+
+                // Current resource usage of the strategy.
+
+                Footprint footprint() const
+                {
+                    return std::visit([mode = mode](auto const & decode)
+                    {
+                        return decode
+                             ? Footprint{mode,
+                                         true,
+                                         decode->residentBytes(),
+                                         std::chrono::duration_cast<std::chrono::microseconds>(decode->planDuration())}
+                             : Footprint{mode, false, 0, {}};
+                    }, decode);
+                }
             };
 
-            // Since a strategy can be neither moved nor copied, we must
-            // instantiate them in-place. Note that with the advent of the
-            // multi-decoder, mode identifiers became a bitset instead of
-            // integral values. The order defined here is the order that
-            // the decode loop will run in; we're matching the Fortran
-            // version here in terms of faster modes first.
+            // Note that with the advent of the multi-decoder, mode identifiers
+            // became a bitset instead of integral values. The modes run
+            // concurrently, but the order defined here is the order in which
+            // their events will be reported, so it's by expected duration of
+            // the decode, i.e., by period, shortest first; a mode's events
+            // then rarely have to wait on those of a slower one.
 
             template <typename ModeType>
-            DecodeEntry makeDecodeEntry(int   shift,
-                                        int & kpos,
-                                        int & ksz)
+            DecodeEntry makeDecodeEntry(std::size_t shift)
             {
                 return DecodeEntry(std::in_place_type<DecodeMode<ModeType>>,
-                                   1 << shift,
-                                   kpos,
-                                   ksz);
+                                   shift,
+                                   std::chrono::seconds(JS8::Submode::period(ModeType::NSUBMODE)));
             }
 
-            std::array<DecodeEntry, 5> m_decodes =
+            std::array<DecodeEntry, JS8_ENABLE_JS8I ? 5 : 4> m_decodes =
             {{
-                makeDecodeEntry<ModeI>(4, m_data.params.kposI, m_data.params.kszI),
-                makeDecodeEntry<ModeE>(3, m_data.params.kposE, m_data.params.kszE),
-                makeDecodeEntry<ModeC>(2, m_data.params.kposC, m_data.params.kszC),
-                makeDecodeEntry<ModeB>(1, m_data.params.kposB, m_data.params.kszB),
-                makeDecodeEntry<ModeA>(0, m_data.params.kposA, m_data.params.kszA)
+#if JS8_ENABLE_JS8I
+                makeDecodeEntry<ModeI>(4),
+#endif
+                makeDecodeEntry<ModeC>(2),
+                makeDecodeEntry<ModeB>(1),
+                makeDecodeEntry<ModeA>(0),
+                makeDecodeEntry<ModeE>(3)
             }};
 
+            // Run the decode strategy of an entry, creating it if need be,
+            // collecting its events, and returning the number of decodes.
+
+            std::size_t execute(DecodeEntry                         & entry,
+                                Snapshot                      const & snapshot,
+                                std::chrono::steady_clock::time_point deadline)
+            {
+                entry.create();
+
+                return std::visit([&](auto && decode) {
+                    return (*decode)(m_params,
+                                     snapshot,
+                                     deadline,
+                                     [&events = entry.events](Event::Variant const & event)
+                                     {
+                                         events.push_back(event);
+                                     });
+                }, entry.decode);
+            }
+
+            // Publish the current resource usage of each strategy.
+
+            void report()
+            {
+                std::lock_guard<std::mutex> lock(m_footprints.mutex);
+
+                m_footprints.entries.clear();
+
+                for (auto const & entry : m_decodes)
+                {
+                    m_footprints.entries.push_back(entry.footprint());
+                }
+            }
+
         public:
 
             // Constructor
 
-            explicit Impl(struct dec_data & data)
-            : m_data(data)
-            {}
+            Impl(DecodeParams            const & params,
+                 std::array<Snapshot, 5>       & snapshots,
+                 std::atomic<int>        const & submodes,
+                 Footprints                    & footprints)
+            : m_params    (params)
+            , m_snapshots (snapshots)
+            , m_submodes  (submodes)
+            , m_footprints(footprints)
+            {
+                report();
+            }
 
             // Execute a decoding pass, using the supplied event emitter to
             // emit events as they occur.
 
-            void operator()(Event::Emitter emitEvent)
+            template <typename Emitter>
+            void operator()(Emitter && emitEvent)
             {
                 // The multi-decoder can provide data for multiple modes at
                 // the same time; specific decodes to be performed for this
                 // pass are in the `nsubmodes` bitset.
 
-                auto const  set = m_data.params.nsubmodes;
+                auto const  set = m_params.nsubmodes;
                 std::size_t sum = 0;
 
+                // Take ownership of the snapshots for this pass; they'll be
+                // released, and any spans they pin unpinned, when we're done.
+
+                auto const snapshots = std::exchange(m_snapshots, {});
+
+                // Release the strategies for any modes that have been
+                // disabled, unless they're scheduled for this pass anyway.
+
+                auto const enabled = m_submodes.load() | set;
+
+                for (auto & entry : m_decodes)
+                {
+                    if ((enabled & entry.mode) != entry.mode) entry.release();
+                }
+
+                // Each mode must finish before its next window is due, so
+                // each gets a deadline from its own period; a slow mode no
+                // longer holds the faster ones to its own schedule, nor do
+                // they cut it short of the time its period allows.
+
+                using Clock = std::chrono::steady_clock;
+
+                auto const start = Clock::now();
+
                 // Let any interested parties know that we've started a run
                 // for the set of modes requested.
 
                 emitEvent(Event::DecodeStarted{set});
 
-                // Iterate through all the modes we're aware of, performing
-                // a mode-specific decode pass if the mode is scheduled for
-                // decoding during this pass.
+                // Dispatch a mode-specific decode pass onto a thread of the
+                // pool for each mode that's scheduled for decoding during this
+                // pass. Each decode strategy owns its plans and buffers, so
+                // they're entirely independent of one another, and the total
+                // time taken should approach that of the slowest mode. If the
+                // pool has no thread free for a mode, we'll run it ourselves,
+                // unless a thread is freed up by the time we get to it.
+                //
+                // Events from each pass are collected rather than emitted as
+                // they occur; we emit them below in the order defined by the
+                // decode entries, such that event order is deterministic.
+                // Events are trivially copyable, and each entry reuses its
+                // collection from run to run, so this doesn't allocate once
+                // we're warmed up.
+
+                struct Run
+                {
+                    Impl                    * impl;
+                    DecodeEntry             * entry;
+                    Snapshot          const * snapshot;
+                    Clock::time_point         deadline;
+                    std::mutex              * mutex;
+                    std::condition_variable * finished;
+                    std::size_t               result = 0;
+                    bool                      pooled = false;
+                    bool                      done   = false;
+
+                    void operator()()
+                    {
+                        auto const decodes = impl->execute(*entry, *snapshot, deadline);
+
+                        std::lock_guard<std::mutex> lock(*mutex);
+
+                        result = decodes;
+                        done   = true;
+
+                        finished->notify_all();
+                    }
+                };
+
+                using Runs = std::array<Run, std::tuple_size_v<decltype(m_decodes)>>;
+
+                auto & pool = Pool::instance();
+
+                std::mutex              mutex;
+                std::condition_variable finished;
+                Runs                    runs;
+                std::size_t             count = 0;
 
                 for (auto & entry : m_decodes)
                 {
                     if ((set & entry.mode) == entry.mode)
                     {
-                        std::visit([&](auto && decode) {
-                            sum += decode(m_data,
-                                          entry.kpos,
-                                          entry.ksz,
-                                          emitEvent);
-                        }, entry.decode);
+                        entry.events.clear();
+
+                        runs[count++] = {this,
+                                         &entry,
+                                         &snapshots[entry.shift],
+                                         start + std::chrono::duration_cast<Clock::duration>(entry.period * DEADLINE_FRACTION),
+                                         &mutex,
+                                         &finished};
+                    }
+                }
+
+                auto const dispatch = [&](std::size_t const first)
+                {
+                    for (auto i = first; i < count; ++i)
+                    {
+                        if (!runs[i].pooled && pool.reserve(1))
+                        {
+                            runs[i].pooled = true;
+                            pool.post(runs[i]);
+                        }
+                    }
+                };
+
+                dispatch(0);
+
+                // Wait for each pass in turn, emitting its events once it's
+                // complete, having first handed off any of those following
+                // it that are still ours, should threads have been freed up.
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    auto & run = runs[i];
+
+                    dispatch(i + 1);
+
+                    if (run.pooled)
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        finished.wait(lock, [&run] { return run.done; });
+                    }
+                    else
+                    {
+                        run();
                     }
+
+                    sum += run.result;
+
+                    for (auto const & event : run.entry->events) emitEvent(event);
                 }
 
+                report();
+
                 // Let any interested parties know the total number of decodes
                 // performed during this run.
 
                 emitEvent(Event::DecodeFinished{sum});
             }
+
+            // Get a head start on the next decoding pass of each enabled mode
+            // for which we've been provided a snapshot of its window so far.
+            // This is done between passes, and is incremental, so it's quick
+            // enough that we can do it serially.
+
+            void prime(std::array<Snapshot, 5> const & snapshots,
+                       int                       const epoch)
+            {
+                auto const enabled = m_submodes.load();
+
+                for (auto & entry : m_decodes)
+                {
+                    if ((enabled & entry.mode) != entry.mode || !snapshots[entry.shift]) continue;
+
+                    entry.create();
+
+                    std::visit([&](auto & decode)
+                    {
+                        decode->prime(snapshots[entry.shift], epoch);
+                    }, entry.decode);
+                }
+
+                report();
+            }
         };
 
+        // Number of queue slots held back for events that we can't
+        // afford to lose; sync state diagnostics are expendable, but
+        // those that report decodes or delimit a run are not, nor is a
+        // sync start, as the drift computed for the decodes following
+        // it is relative to the window position that it reports.
+
+        static constexpr std::size_t RESERVE = 256;
+
         // Data members
 
-        QSemaphore      * m_semaphore;
-        std::atomic<bool> m_quit = false;
-        struct dec_data   m_data;
+        Capture const         & m_capture;
+        QSemaphore            * m_semaphore;
+        Event::Queue          * m_events;
+        Decoder               * m_decoder;
+        std::atomic<bool>       m_quit     = false;
+        std::atomic<int>        m_submodes = ~0;
+        DecodeParams            m_params;
+        std::array<Snapshot, 5> m_snapshots;
+        Footprints              m_footprints;
+        std::atomic<bool>       m_decodePending = false;
+        std::mutex              m_decodeMutex;
+        DecodeParams            m_decodeParams;
+        std::array<Snapshot, 5> m_decodeSnapshots;
+        std::mutex              m_primeMutex;
+        std::array<Snapshot, 5> m_primeSnapshots;
+        int                     m_primeEpoch    = 0;
+
+        // Hand an event off to the queue, and let the decoder know that
+        // it's got something to drain. We never wait on the GUI thread;
+        // expendable events are dropped if the queue is near capacity,
+        // others only if it's full, and the queue counts each one that
+        // it refuses.
+
+        void post(Event::Variant const & event)
+        {
+            m_events->push(event, std::holds_alternative<Event::SyncState>(event) ? RESERVE : 0);
+            m_decoder->notify();
+        }
 
     public:
 
         // Constructor
 
-        explicit Worker(QSemaphore * semaphore,
-                        QObject    * parent = nullptr)
+        explicit Worker(Capture const & capture,
+                        QSemaphore    * semaphore,
+                        Event::Queue  * events,
+                        Decoder       * decoder,
+                        QObject       * parent = nullptr)
         : QObject    (parent)
+        , m_capture  (capture)
         , m_semaphore(semaphore)
+        , m_events   (events)
+        , m_decoder  (decoder)
         {}
 
         // Used to inform the worker that it's time to go; the next
@@ -2549,20 +4178,79 @@ namespace JS8
             m_quit = true;
         }
 
-        // Called by the owning Decoder to refresh the copy of the
-        // decode data that the Worker implementation references.
+        // Called by the owning Decoder to change the set of submodes
+        // that are enabled; takes effect at the next decoding pass.
+
+        void setSubmodes(int const submodes)
+        {
+            m_submodes = submodes;
+        }
+
+        // Called by the owning Decoder to obtain the current resource
+        // usage of the decode strategies.
+
+        std::vector<Footprint> footprint() const
+        {
+            std::lock_guard<std::mutex> lock(m_footprints.mutex);
+
+            return m_footprints.entries;
+        }
+
+        // Called by the owning Decoder, with writers to the capture
+        // buffer held off, to copy the decode parameters, and to pin the
+        // span of the capture buffer to be decoded for each scheduled
+        // submode, for the next run. These replace any that we've not yet
+        // gotten around to; a run in progress has its own copies, taken
+        // when it started, so it's unaffected. Snapshots are indexed by
+        // submode bit.
 
         void copy()
         {
-            m_data = dec_data;
+            std::lock_guard<std::mutex> lock(m_decodeMutex);
+
+            m_decodeParams = m_capture.params;
+
+            std::array<std::pair<int, int>, 5> const spans =
+            {{
+                {m_decodeParams.kposA, m_decodeParams.kszA},
+                {m_decodeParams.kposB, m_decodeParams.kszB},
+                {m_decodeParams.kposC, m_decodeParams.kszC},
+                {m_decodeParams.kposE, m_decodeParams.kszE},
+                {m_decodeParams.kposI, m_decodeParams.kszI}
+            }};
+
+            for (std::size_t shift = 0; shift < spans.size(); ++shift)
+            {
+                auto const [kpos, ksz] = spans[shift];
+
+                m_decodeSnapshots[shift] = (m_decodeParams.nsubmodes & (1 << shift))
+                                         ? Snapshot(m_capture, std::max(0, kpos), std::max(0, ksz))
+                                         : Snapshot();
+            }
+
+            m_decodePending = true;
         };
 
-    signals:
+        // Called by the owning Decoder, with writers to the capture
+        // buffer held off, to pin the spans of the capture buffer that
+        // we should get a head start on, indexed by submode bit. Spans
+        // replace any that we've not yet gotten around to.
 
-        // Signal used to indicate that something of interest has
-        // occurred during a decoding pass.
+        void copyPrime(std::array<std::pair<int, int>, 5> const & spans)
+        {
+            std::lock_guard<std::mutex> lock(m_primeMutex);
 
-        void decodeEvent(Event::Variant const &);
+            for (std::size_t shift = 0; shift < spans.size(); ++shift)
+            {
+                auto const [kpos, ksz] = spans[shift];
+
+                m_primeSnapshots[shift] = ksz > 0
+                                        ? Snapshot(m_capture, std::max(0, kpos), ksz)
+                                        : Snapshot();
+            }
+
+            m_primeEpoch = m_capture.params.epoch;
+        }
 
     public slots:
 
@@ -2574,16 +4262,18 @@ namespace JS8
         void run()
         {
             // Our thread has started, and we're now running on it, so
-            // we're good to now allocate our implementation; we didn't
-            // want that to happen on the main thread, as the FFT plans
-            // can take a while. We only need the implementation while
-            // we're running.
+            // we're good to now allocate our implementation. We only
+            // need the implementation while we're running.
 
-            std::unique_ptr<Impl> impl = std::make_unique<Impl>(m_data);
+            std::unique_ptr<Impl> impl = std::make_unique<Impl>(m_params,
+                                                                m_snapshots,
+                                                                m_submodes,
+                                                                m_footprints);
 
             // Wait until there's something that requires our attention,
-            // which is going to either be needing to quit or needing to
-            // perform a decoding pass.
+            // which is going to either be needing to quit, needing to
+            // perform a decoding pass, or, failing that, getting a head
+            // start on the next one.
 
             while (true)
             {
@@ -2591,10 +4281,34 @@ namespace JS8
 
                 if (m_quit) break;
 
-                (*impl)([this](Event::Variant const & event)
+                if (m_decodePending.exchange(false))
                 {
-                    emit decodeEvent(event);
-                });
+                    {
+                        std::lock_guard<std::mutex> lock(m_decodeMutex);
+
+                        m_params    = m_decodeParams;
+                        m_snapshots = std::exchange(m_decodeSnapshots, {});
+                    }
+
+                    (*impl)([this](Event::Variant const & event)
+                    {
+                        post(event);
+                    });
+                }
+                else
+                {
+                    std::array<Snapshot, 5> snapshots;
+                    int                     epoch;
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_primeMutex);
+
+                        snapshots = std::exchange(m_primeSnapshots, {});
+                        epoch     = m_primeEpoch;
+                    }
+
+                    impl->prime(snapshots, epoch);
+                }
             }
         }
     };
@@ -2608,16 +4322,61 @@ namespace JS8
 
 namespace JS8
 {
-    Decoder::Decoder(QObject * parent)
+    Decoder::Decoder(Capture const & capture,
+                     QObject       * parent)
     : QObject(parent)
     , m_semaphore(0)
-    , m_worker(new Worker(&m_semaphore))
+    , m_worker(new Worker(capture, &m_semaphore, &m_events, this))
     {
         m_worker->moveToThread(&m_thread);
 
-        connect(&m_thread, &QThread::started,    m_worker, &Worker::run);
-        connect(&m_thread, &QThread::finished,   m_worker, &QObject::deleteLater);
-        connect(m_worker,  &Worker::decodeEvent, this,     &Decoder::decodeEvent);
+        connect(&m_thread, &QThread::started,  m_worker, &Worker::run);
+        connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    }
+
+    void
+    Decoder::setSubmodes(int const submodes)
+    {
+        m_worker->setSubmodes(submodes);
+    }
+
+    std::vector<Footprint>
+    Decoder::footprint() const
+    {
+        return m_worker->footprint();
+    }
+
+    void
+    Decoder::notify()
+    {
+        if (!m_drainPending.exchange(true))
+        {
+            QMetaObject::invokeMethod(this, &Decoder::drain, Qt::QueuedConnection);
+        }
+    }
+
+    void
+    Decoder::drain()
+    {
+        // Clear the pending flag prior to draining; anything pushed after
+        // we've looked at the queue will schedule another drain.
+
+        m_drainPending = false;
+
+        m_events.drain([this](Event::Variant const & event)
+        {
+            emit decodeEvent(event);
+        });
+
+        if (auto const overflows  = m_events.overflows();
+                       overflows != m_overflows)
+        {
+            qWarning() << "decoder event queue full; refused"
+                       << overflows - m_overflows
+                       << "events";
+
+            m_overflows = overflows;
+        }
     }
 
     void
@@ -2641,6 +4400,125 @@ namespace JS8
         m_worker->copy();
         m_semaphore.release();
     }
+
+    void
+    Decoder::prime(std::array<std::pair<int, int>, 5> const & spans)
+    {
+        m_worker->copyPrime(spans);
+        m_semaphore.release();
+    }
+}
+
+/******************************************************************************/
+// Public Interface - Buffer Decoding
+/******************************************************************************/
+
+namespace JS8
+{
+    struct BufferDecoder::Impl
+    {
+        std::variant<
+#if JS8_ENABLE_JS8I
+            std::unique_ptr<DecodeMode<ModeI>>,
+#endif
+            std::unique_ptr<DecodeMode<ModeE>>,
+            std::unique_ptr<DecodeMode<ModeC>>,
+            std::unique_ptr<DecodeMode<ModeB>>,
+            std::unique_ptr<DecodeMode<ModeA>>
+        >           decode;
+        std::size_t size;
+
+        template <typename Mode>
+        explicit Impl(std::in_place_type_t<Mode>)
+        : decode(std::make_unique<DecodeMode<Mode>>())
+        , size  (Mode::NMAX)
+        {}
+    };
+
+    BufferDecoder::BufferDecoder(int const submode)
+    : m_impl([submode]
+      {
+          switch (submode)
+          {
+              case ModeA::NSUBMODE: return std::make_unique<Impl>(std::in_place_type<ModeA>);
+              case ModeB::NSUBMODE: return std::make_unique<Impl>(std::in_place_type<ModeB>);
+              case ModeC::NSUBMODE: return std::make_unique<Impl>(std::in_place_type<ModeC>);
+              case ModeE::NSUBMODE: return std::make_unique<Impl>(std::in_place_type<ModeE>);
+#if JS8_ENABLE_JS8I
+              case ModeI::NSUBMODE: return std::make_unique<Impl>(std::in_place_type<ModeI>);
+#endif
+              default: throw std::runtime_error("Unsupported submode");
+          }
+      }())
+    {}
+
+    BufferDecoder::~BufferDecoder() = default;
+
+    BufferDecoder::BufferDecoder            (BufferDecoder &&) noexcept = default;
+    BufferDecoder & BufferDecoder::operator=(BufferDecoder &&) noexcept = default;
+
+    std::size_t
+    BufferDecoder::decode(Options                     const & options,
+                          std::int16_t                const * samples,
+                          std::size_t                 const   size,
+                          std::vector<Event::Variant>       & events)
+    {
+        DecodeParams params{};
+
+        params.nutc      = options.utc;
+        params.nfqso     = options.nfqso;
+        params.nfa       = options.nfa;
+        params.nfb       = options.nfb;
+        params.syncStats = options.syncStats;
+
+        // Samples provided by the caller have no position in the capture
+        // buffer, so the decoder won't attempt to cache anything about them.
+
+        Snapshot const snapshot(samples,
+                                static_cast<int>(std::min(size, m_impl->size)));
+
+        // No budget means no deadline.
+
+        auto const deadline = options.budget == options.budget.zero()
+                            ? std::chrono::steady_clock::time_point::max()
+                            : std::chrono::steady_clock::now() + options.budget;
+
+        return std::visit([&](auto & decode)
+        {
+            decode->setBPVariant(options.bpVariant);
+            decode->setSyncExact(options.syncExact);
+
+            return (*decode)(params,
+                             snapshot,
+                             deadline,
+                             [&events](Event::Variant const & event)
+                             {
+                                 events.push_back(event);
+                             });
+        }, m_impl->decode);
+    }
+
+    BufferDecoder::TableErrors
+    BufferDecoder::checkTables()
+    {
+        return std::visit([](auto & decode)
+        {
+            auto const [reference, sync] = decode->checkTables();
+
+            return TableErrors{reference, sync};
+        }, m_impl->decode);
+    }
+
+    BufferDecoder::SyncErrors
+    BufferDecoder::checkSync()
+    {
+        return std::visit([](auto & decode)
+        {
+            auto const [exact, fast, lags] = decode->checkSync();
+
+            return SyncErrors{exact, fast, lags};
+        }, m_impl->decode);
+    }
 }
 
 /******************************************************************************/
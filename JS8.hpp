@@ -2,12 +2,21 @@
 #define __JS8
 
 #include <array>
-#include <functional>
-#include <string>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <variant>
+#include <vector>
 #include <QObject>
 #include <QSemaphore>
 #include <QThread>
+#include "JS8Snapshot.hpp"
 
 namespace JS8
 {
@@ -87,16 +96,50 @@ namespace JS8
       } sync;
     };
 
+    // Decoded frames are always 12 characters; they're carried inline,
+    // and are not null-terminated, so that events remain trivially
+    // copyable.
+
     struct Decoded
     {
-      int         utc;  // you can use the output of code_time() from commons.h here.
-      int         snr;
-      float       xdt;
-      float       frequency;
-      std::string data;
-      int         type;
-      float       quality;
-      int         mode;
+      int                  utc;  // you can use the output of code_time() from commons.h here.
+      int                  snr;
+      float                xdt;
+      float                frequency;
+      std::array<char, 12> data;
+      int                  type;
+      float                quality;
+      int                  mode;
+
+      std::string_view text() const { return {data.data(), data.size()}; }
+    };
+
+    // Instrumentation of a decode of a single submode, reported once the
+    // decode of the submode is complete. Downsampling, demodulation, and
+    // belief propagation run in parallel on busy bands, so their times
+    // are summed across threads, and may together exceed the total. Work that was skipped
+    // in order to meet the decode deadline is counted as well, as are
+    // candidates recognized as signals decoded by an earlier run.
+
+    struct DecodeStats
+    {
+      int                       mode;
+      int                       passes;
+      std::array<int, 3>        candidates;   // per pass
+      int                       bpIterations;
+      int                       bpFailures;
+      int                       crcRejects;
+      int                       reducedPasses;      // passes with limited BP effort
+      int                       skippedPasses;
+      int                       skippedCandidates;
+      int                       knownCandidates;
+      std::chrono::microseconds sync;
+      std::chrono::microseconds spectra;            // of sync, computing symbol spectra
+      std::chrono::microseconds downsample;
+      std::chrono::microseconds demodulate;         // exclusive of belief propagation
+      std::chrono::microseconds bp;
+      std::chrono::microseconds subtract;
+      std::chrono::microseconds total;
     };
 
     struct DecodeFinished
@@ -108,27 +151,239 @@ namespace JS8
                                  SyncStart,
                                  SyncState,
                                  Decoded,
+                                 DecodeStats,
                                  DecodeFinished>;
 
-    using Emitter = std::function<void(Variant const &)>;
+    static_assert(std::is_trivially_copyable_v<Variant>);
+
+    // Fixed-capacity, lock-free, single producer, single consumer queue
+    // of events, by which the decoder thread hands events off to the GUI
+    // thread without allocating or copying anything but the events. The
+    // producer must not block on the consumer, so when the queue is full,
+    // push() fails, and the number of such failures is counted.
+
+    class Queue
+    {
+    public:
+
+      static constexpr std::size_t CAPACITY = 4096;
+
+      static_assert(std::has_single_bit(CAPACITY));
+
+      // Producer side; returns false if the queue was full, or, if a
+      // reserve is specified, if no more than that many slots remained.
+
+      bool
+      push(Variant     const & event,
+           std::size_t const   reserve = 0)
+      {
+        auto const tail = m_tail.load(std::memory_order_relaxed);
+
+        if (CAPACITY - (tail - m_head.load(std::memory_order_acquire)) <= reserve)
+        {
+          m_overflows.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+
+        m_events[tail & (CAPACITY - 1)] = event;
+        m_tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+      }
+
+      // Consumer side; invokes the provided function on each event that
+      // is currently queued, in order, returning the number consumed.
+
+      template <typename Function>
+      std::size_t
+      drain(Function && function)
+      {
+        auto const head = m_head.load(std::memory_order_relaxed);
+        auto const tail = m_tail.load(std::memory_order_acquire);
+
+        for (auto i = head; i != tail; ++i)
+        {
+          function(m_events[i & (CAPACITY - 1)]);
+        }
+
+        m_head.store(tail, std::memory_order_release);
+
+        return tail - head;
+      }
+
+      // Number of events that have been refused due to the queue being
+      // full, since construction.
+
+      std::size_t
+      overflows() const
+      {
+        return m_overflows.load(std::memory_order_relaxed);
+      }
+
+    private:
+
+      std::array<Variant, CAPACITY>         m_events;
+      alignas(64) std::atomic<std::size_t>  m_head      = 0;
+      alignas(64) std::atomic<std::size_t>  m_tail      = 0;
+      alignas(64) std::atomic<std::size_t>  m_overflows = 0;
+    };
   }
 
+  // Check node update rule of the belief propagation decoder. Sum-product
+  // is a faithful reproduction of the Fortran version, and is the rule we
+  // use unless told otherwise. The min-sum variants replace its tanh and
+  // atanh products with a sign product and a minimum magnitude, which is
+  // far cheaper, at some cost in sensitivity; offset min-sum recovers most
+  // of that cost.
+
+  enum class BPVariant
+  {
+    SumProduct,
+    MinSum,
+    OffsetMinSum
+  };
+
+  // Resource usage of the decoder for a submode, identified by its bit
+  // in the decode submode set. Decoders are created when their submode
+  // is first decoded, and released when it's no longer enabled; bytes
+  // excludes FFTW's internal allocations for the plans.
+
+  struct Footprint
+  {
+    int                       mode;
+    bool                      resident;
+    std::size_t               bytes;
+    std::chrono::microseconds planTime;
+  };
+
+  // Synchronous decoder for a single submode, operating on a buffer of
+  // 12 kHz samples provided by the caller, rather than on the capture
+  // buffer; independent of the GUI. An instance may be used by only one
+  // thread at a time, but any number of them may be used concurrently.
+
+  class BufferDecoder
+  {
+  public:
+
+    // Decode parameters; the UTC is reported as-is in decoded events,
+    // and frequencies are in Hz.
+
+    struct Options
+    {
+      int                       utc       = 0;      // you can use the output of code_time() from commons.h here.
+      int                       nfqso     = 1500;
+      int                       nfa       = 0;
+      int                       nfb       = 5000;
+      bool                      syncStats = false;
+      std::chrono::milliseconds budget    = {};     // time allowed for the decode; zero for no limit
+      BPVariant                 bpVariant = BPVariant::SumProduct;
+      bool                      syncExact = false;  // sum sync tone power in the Fortran version's order
+    };
+
+    // Constructor; throws if the submode isn't one that's compiled in.
+
+    explicit BufferDecoder(int submode);
+    ~BufferDecoder();
+
+    BufferDecoder            (BufferDecoder &&) noexcept;
+    BufferDecoder & operator=(BufferDecoder &&) noexcept;
+
+    // Decode the samples, which should start at the start of a period;
+    // samples beyond those the submode needs are ignored. Events are
+    // appended to the vector provided, and the number of unique decodes
+    // is returned.
+
+    std::size_t decode(Options                     const & options,
+                       std::int16_t                const * samples,
+                       std::size_t                         size,
+                       std::vector<Event::Variant>       & events);
+
+    // Check the precomputed waveform tables with which we synthesize
+    // reference signals for subtraction, and search for fine sync,
+    // against direct computation in double precision; the largest error
+    // found in each, relative to the magnitude of the exact value.
+
+    struct TableErrors
+    {
+      double reference;
+      double sync;
+    };
+
+    TableErrors checkTables();
+
+    // Check the sync search against the Fortran version's, over random
+    // symbol spectra; the largest error of the sync metric found, relative
+    // to the Fortran version's, in exact mode and otherwise, and the number
+    // of bins at which exact mode found a different lag. Exact mode should
+    // reproduce the Fortran version's results, i.e., both should be zero.
+
+    struct SyncErrors
+    {
+      double exact;
+      double fast;
+      int    lags;
+    };
+
+    SyncErrors checkSync();
+
+  private:
+
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
   class Worker;
 
   class Decoder: public QObject
   {
     Q_OBJECT
 
-    QSemaphore m_semaphore;
-    QThread    m_thread;
-    Worker   * m_worker;
+    QSemaphore        m_semaphore;
+    QThread           m_thread;
+    Event::Queue      m_events;
+    std::atomic<bool> m_drainPending = false;
+    std::size_t       m_overflows    = 0;
+    Worker          * m_worker;
 
   public:
 
-    Decoder(QObject * parent = nullptr);
+    // Constructor; decodes take their parameters and samples from the
+    // capture buffer provided, which must outlive us.
+
+    explicit Decoder(Capture const & capture,
+                     QObject       * parent = nullptr);
+
+    // Set of submodes, in terms of decode submode bits, that we should
+    // expect to decode; decoders for submodes outside of the set will be
+    // released prior to the next decoding pass. All submodes are enabled
+    // by default.
+
+    void setSubmodes(int submodes);
+
+    // Resource usage of the decoder for each submode that's compiled in.
+
+    std::vector<Footprint> footprint() const;
+
+    // Get a head start on the next decode, while the decoder would be
+    // otherwise idle, by computing in advance what can be computed from
+    // what's been captured of the windows to be decoded. Spans are of
+    // the capture buffer, as position and size, indexed by decode submode
+    // bit; empty spans are ignored. Like decode(), must be called with
+    // writers to the capture buffer held off.
+
+    void prime(std::array<std::pair<int, int>, 5> const & spans);
+
+    // Called from the decoder thread after pushing events onto the
+    // queue; arranges for a drain on our thread, unless one is already
+    // pending, in which case it will pick up the new events as well.
+
+    void notify();
 
   signals:
 
+      // Emitted on our thread for each event drained from the queue,
+      // in the order in which the decoder produced them.
+
       void decodeEvent(Event::Variant const &);
 
   public slots:
@@ -136,6 +391,10 @@ namespace JS8
     void start(QThread::Priority priority);
     void quit();
     void decode();
+
+  private slots:
+
+    void drain();
   };
 }
 
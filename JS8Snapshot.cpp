@@ -0,0 +1,259 @@
+#include "JS8Snapshot.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "commons.h"
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+// Registry entry for a pinned span. The mutex serializes copying the span
+// out of the ring with detaching it; it's taken while holding the registry
+// mutex, never the other way around.
+
+struct JS8::Snapshot::Pin
+{
+  JS8::Capture const * capture;
+  int                  position;
+  int                  index;
+  int                  size;
+  std::mutex           mutex;
+  bool                 detached = false;
+  std::vector<float>   samples;
+
+  Pin(JS8::Capture const * const capture,
+      int                  const position,
+      int                  const index,
+      int                  const size)
+  : capture (capture)
+  , position(position)
+  , index   (index)
+  , size    (size)
+  {}
+};
+
+namespace
+{
+  constexpr int RING = JS8_RX_SAMPLE_SIZE;
+
+  // Registry of pinned spans, and the mutex protecting it, along with the
+  // pins themselves. The registry doesn't keep pins alive; snapshots do.
+
+  std::mutex                                     registryMutex;
+  std::vector<std::weak_ptr<JS8::Snapshot::Pin>> registry;
+
+  // Normalize a ring position to the range [0, RING).
+
+  int
+  normalize(int const position)
+  {
+    return ((position % RING) + RING) % RING;
+  }
+
+  // Determine if two spans of the ring overlap, accounting for wrap.
+
+  bool
+  overlaps(int const a, int const aSize,
+           int const b, int const bSize)
+  {
+    if (aSize <= 0 || bSize <= 0) return false;
+
+    auto const d = normalize(b - a);
+
+    return d < aSize || (RING - d) < bSize;
+  }
+
+  // Invoke the provided function on the one or two contiguous segments of
+  // the ring of a capture buffer that make up a span, starting at an index,
+  // in order.
+
+  template <typename Capture,
+            typename Function>
+  void
+  segments(Capture  & capture,
+           int const  index,
+           int const  size,
+           Function && function)
+  {
+    auto const first = std::min(size, RING - index);
+
+    function(std::begin(capture.d2) + index, first);
+
+    if (first < size) function(std::begin(capture.d2), size - first);
+  }
+
+  // Make a private copy of the content of any pin of the capture buffer
+  // that satisfies the predicate, and prune any pins that are no longer
+  // referenced. Caller must hold the registry mutex; should a snapshot be
+  // copying out a pin that we must detach, we'll wait for it to finish.
+
+  template <typename Predicate>
+  void
+  detachIf(JS8::Capture const & capture,
+           Predicate         && predicate)
+  {
+    std::erase_if(registry, [&](auto const & weak)
+    {
+      auto const pin = weak.lock();
+
+      if (!pin) return true;
+
+      if (pin->capture != &capture || !predicate(*pin)) return false;
+
+      std::lock_guard<std::mutex> lock(pin->mutex);
+
+      if (!pin->detached)
+      {
+        pin->samples.reserve(pin->size);
+
+        segments(capture, pin->index, pin->size, [&](auto const begin, int const count)
+        {
+          pin->samples.insert(pin->samples.end(), begin, begin + count);
+        });
+
+        pin->detached = true;
+      }
+
+      return false;
+    });
+  }
+}
+
+/******************************************************************************/
+// Public Interface
+/******************************************************************************/
+
+namespace JS8
+{
+  Snapshot::Snapshot(Capture const & capture,
+                     int     const   position,
+                     int     const   size)
+  : m_pin(std::make_shared<Pin>(&capture,
+                                normalize(position),
+                                locate(capture, position),
+                                std::clamp(size, 0, RING)))
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::erase_if(registry, [](auto const & weak) { return weak.expired(); });
+
+    registry.push_back(m_pin);
+  }
+
+  Snapshot::Snapshot(std::int16_t const * const samples,
+                     int                  const size)
+  : m_pin(std::make_shared<Pin>(nullptr, -1, -1, std::max(size, 0)))
+  {
+    m_pin->samples.assign(samples, samples + m_pin->size);
+    m_pin->detached = true;
+  }
+
+  int
+  Snapshot::position() const
+  {
+    return m_pin ? m_pin->position : 0;
+  }
+
+  int
+  Snapshot::index() const
+  {
+    return m_pin ? m_pin->index : 0;
+  }
+
+  int
+  Snapshot::size() const
+  {
+    return m_pin ? m_pin->size : 0;
+  }
+
+  void
+  Snapshot::copy(float * out) const
+  {
+    if (!m_pin) return;
+
+    // Holding the pin's mutex keeps writers from modifying the span until
+    // we're done with it, without holding up anything else.
+
+    std::lock_guard<std::mutex> lock(m_pin->mutex);
+
+    auto const convert = [](auto const value)
+    {
+      return static_cast<float>(value);
+    };
+
+    if (m_pin->detached)
+    {
+      std::transform(m_pin->samples.begin(),
+                     m_pin->samples.end(),
+                     out,
+                     convert);
+    }
+    else
+    {
+      segments(*m_pin->capture, m_pin->index, m_pin->size, [&](auto const begin, int const count)
+      {
+        out = std::transform(begin, begin + count, out, convert);
+      });
+    }
+  }
+
+  int
+  locate(Capture const & capture,
+         int     const   position)
+  {
+    return static_cast<int>(((capture.params.origin + position) % RING + RING) % RING);
+  }
+
+  void
+  detach(Capture const & capture,
+         int     const   position,
+         int     const   size)
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    detachIf(capture, [index = locate(capture, position), size](auto const & pin)
+    {
+      return overlaps(pin.index, pin.size, index, size);
+    });
+  }
+
+  void
+  detach(Capture const & capture)
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    detachIf(capture, [](auto const &) { return true; });
+  }
+
+  void
+  write(Capture       &       capture,
+        int           const   position,
+        float const * const   samples,
+        int           const   size)
+  {
+    detach(capture, position, size);
+
+    auto in = samples;
+
+    segments(capture, locate(capture, position), std::clamp(size, 0, RING), [&](auto const begin, int const count)
+    {
+      std::copy_n(in, count, begin);
+      in += count;
+    });
+  }
+
+  void
+  clear(Capture & capture,
+        int const position,
+        int const size)
+  {
+    detach(capture, position, size);
+
+    segments(capture, locate(capture, position), std::clamp(size, 0, RING), [](auto const begin, int const count)
+    {
+      std::fill_n(begin, count, 0.0f);
+    });
+  }
+}
@@ -0,0 +1,109 @@
+#ifndef JS8_SNAPSHOT_HPP_
+#define JS8_SNAPSHOT_HPP_
+
+#include <cstdint>
+#include <memory>
+
+struct dec_data;
+
+namespace JS8
+{
+  // A capture buffer, i.e., the samples and decode parameters of a
+  // receiver; dec_data is that of the primary receiver, and any other
+  // receivers have their own.
+
+  using Capture = struct ::dec_data;
+
+  // The samples of a capture buffer, i.e., its d2, are circular. Positions in it,
+  // i.e., offsets of samples into the minute, are mapped to indices in
+  // the buffer by way of an origin, the absolute index of the sample at
+  // position zero; the absolute index of the write head, the origin plus
+  // the number of samples written in the period, only ever increases.
+  // Realigning the buffer to the clock adjusts the origin, rather than
+  // moving any data.
+  //
+  // A read-only, reference-counted view of a span of the capture ring
+  // buffer, by which the decoder can work with the samples that it
+  // requires without copying the buffer in order to do so. Spans are in
+  // terms of buffer positions, and as such, may wrap. The content of a
+  // span remains at the same index across realignments of the buffer,
+  // so the index, rather than the position, identifies it.
+  //
+  // Pinned spans are copy-on-write; before modifying the ring, writers
+  // must call detach() for the range they're about to modify, which will
+  // make a private copy of the content of any pinned span that overlaps
+  // it. Writers therefore pay for a copy only in the rare case of overlap,
+  // and never wait on a decode in progress; at most, they'll wait for an
+  // overlapping span that's being copied out at the time to be copied.
+  //
+  // Creation of a snapshot must be serialized with writers to the ring;
+  // in practice, that means holding the mutex of the Detector writing to
+  // the capture buffer.
+  //
+  // A snapshot may alternatively be made of samples that the caller has
+  // provided, in which case they're copied, and it's not associated with
+  // any position in the ring; position() and index() are then -1.
+
+  class Snapshot
+  {
+  public:
+
+    // Implementation detail; registry entry for a pinned span.
+
+    struct Pin;
+
+    // Constructors; the default constructor creates an empty snapshot,
+    // which pins nothing.
+
+    Snapshot() = default;
+    Snapshot(Capture const & capture,
+             int             position,
+             int             size);
+    Snapshot(std::int16_t const * samples,
+             int                  size);
+
+    // Accessors
+
+    int  position() const;
+    int  index()    const;
+    int  size()     const;
+    explicit operator bool() const { return static_cast<bool>(m_pin); }
+
+    // Copy the samples of the span to the provided output, converting
+    // them to floating point in the process; the output must be large
+    // enough to hold size() samples.
+
+    void copy(float * out) const;
+
+  private:
+
+    std::shared_ptr<Pin> m_pin;
+  };
+
+  // Index in the capture buffer of a buffer position.
+
+  int locate(Capture const & capture,
+             int             position);
+
+  // Called by writers to the ring prior to modifying the range of it
+  // starting at the provided position, of the provided size, or, in
+  // the case of no range, prior to modifying any or all of it.
+
+  void detach(Capture const & capture,
+              int             position,
+              int             size);
+  void detach(Capture const & capture);
+
+  // Write samples to, or clear, the range of the ring starting at the
+  // provided position, of the provided size; detaches the range first.
+
+  void write(Capture       & capture,
+             int             position,
+             float const   * samples,
+             int             size);
+  void clear(Capture       & capture,
+             int             position,
+             int             size);
+}
+
+#endif
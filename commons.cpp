@@ -0,0 +1,7 @@
+#include "commons.h"
+
+// Storage shared by the capture side and the decoder. It lives with the
+// decoder, such that the decoder library can be used without the GUI.
+
+struct dec_data dec_data;
+std::mutex      fftw_mutex;
@@ -48,7 +48,7 @@
 
 extern struct dec_data
 {
-  std::int16_t d2[JS8_RX_SAMPLE_SIZE]; // sample frame buffer for sample collection
+  float d2[JS8_RX_SAMPLE_SIZE];        // sample frame buffer for sample collection
   struct
   {
     int nutc;                   // UTC as integer. See code_time() below for details.
@@ -58,6 +58,7 @@ extern struct dec_data
     int nfb;                    // High decode limit (Hz) (filter max)
     bool syncStats;             // only compute sync candidates
     int kin;                    // number of frames written to d2
+    std::int64_t origin;        // absolute sample index of position 0 in d2; see JS8::locate()
     int kposA;                  // starting position of decode for submode A
     int kposB;                  // starting position of decode for submode B
     int kposC;                  // starting position of decode for submode C
@@ -69,6 +70,7 @@ extern struct dec_data
     int kszE;                   // number of frames for decode for submode E
     int kszI;                   // number of frames for decode for submode I
     int nsubmodes;              // which submodes to decode
+    int epoch;                  // incremented when d2 contents are cleared
   } params;
 } dec_data;
 
@@ -240,7 +240,7 @@ DecodedText::tryUnpackDirected(QString const & m)
 // the Fortran decoded emitted.
 
 DecodedText::DecodedText(JS8::Event::Decoded const & decoded)
-: DecodedText(QString::fromStdString(decoded.data),
+: DecodedText(QString::fromLatin1(decoded.data.data(), decoded.data.size()),
               decoded.type,
               decoded.mode,
               decoded.quality < QUALITY_THRESHOLD,
@@ -0,0 +1,582 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <numbers>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QStringList>
+#include "commons.h"
+#include "JS8.hpp"
+#include "JS8Submode.hpp"
+#include "varicode.h"
+
+// Decoder benchmark; synthesizes band scenarios, i.e., a number of JS8
+// signals at a given SNR, spread out in frequency and time, over white
+// Gaussian noise, decodes them, and writes a JSON object per line to
+// stdout for each scenario, reporting what was decoded, how long it
+// took, both in total and by decoder stage, and how much memory
+// allocation was required to do so.
+//
+// Signals are synthesized in the same manner as the modulator does so,
+// i.e., continuous-phase FSK of the tones produced by JS8::encode(), and
+// so the benchmark exercises the entire decoder as it'd be used live.
+// Given more than one belief propagation rule, each decodes the same
+// signals, so as to compare their sensitivity and throughput.
+//
+// With --check, we instead check the waveform tables that the decoder
+// uses in place of direct computation, and its sync search against the
+// Fortran version's, reporting the errors found for each submode, and
+// exiting with failure if any is out of tolerance. Exact sync search
+// must reproduce the Fortran version's results exactly.
+
+/******************************************************************************/
+// Allocation Counting
+/******************************************************************************/
+
+namespace
+{
+  std::atomic<std::size_t> allocations = 0;
+  std::atomic<std::size_t> allocated   = 0;
+}
+
+void *
+operator new(std::size_t const size)
+{
+  allocations.fetch_add(1,    std::memory_order_relaxed);
+  allocated  .fetch_add(size, std::memory_order_relaxed);
+
+  if (auto const p = std::malloc(size ? size : 1)) return p;
+
+  throw std::bad_alloc();
+}
+
+void *
+operator new(std::size_t           const size,
+             std::align_val_t      const align)
+{
+  allocations.fetch_add(1,    std::memory_order_relaxed);
+  allocated  .fetch_add(size, std::memory_order_relaxed);
+
+  auto const alignment = static_cast<std::size_t>(align);
+
+  if (auto const p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) return p;
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void * const p)                                     noexcept { std::free(p); }
+void operator delete(void * const p, std::size_t)                        noexcept { std::free(p); }
+void operator delete(void * const p, std::align_val_t)                   noexcept { std::free(p); }
+void operator delete(void * const p, std::size_t, std::align_val_t)      noexcept { std::free(p); }
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+namespace
+{
+  // Submodes that are compiled in.
+
+  constexpr std::array SUBMODES
+  {
+#if JS8_ENABLE_JS8A
+    static_cast<int>(Varicode::JS8CallNormal),
+#endif
+#if JS8_ENABLE_JS8B
+    static_cast<int>(Varicode::JS8CallFast),
+#endif
+#if JS8_ENABLE_JS8C
+    static_cast<int>(Varicode::JS8CallTurbo),
+#endif
+#if JS8_ENABLE_JS8E
+    static_cast<int>(Varicode::JS8CallSlow),
+#endif
+#if JS8_ENABLE_JS8I
+    static_cast<int>(Varicode::JS8CallUltra),
+#endif
+  };
+
+  // Belief propagation rules, by name.
+
+  constexpr std::array<std::pair<std::string_view, JS8::BPVariant>, 3> BP_VARIANTS
+  {{
+    {"sum-product",    JS8::BPVariant::SumProduct},
+    {"min-sum",        JS8::BPVariant::MinSum},
+    {"offset-min-sum", JS8::BPVariant::OffsetMinSum}
+  }};
+
+  // Characters that may appear in a frame.
+
+  constexpr std::string_view ALPHABET = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-+";
+
+  // Largest error, relative to direct computation, that we'll accept of
+  // the decoder's precomputed waveform tables; single precision leaves
+  // them within about 1e-6.
+
+  constexpr double TABLE_TOLERANCE = 1e-5;
+
+  // Largest error, relative to the Fortran version, that we'll accept of
+  // the sync metric when not in exact mode; summing in a different order
+  // leaves it within a few units in the last place.
+
+  constexpr double SYNC_TOLERANCE = 1e-5;
+
+  // Bandwidth in which SNR is reported, in keeping with the decoder.
+
+  constexpr double SNR_BANDWIDTH = 2500.0;
+
+  struct Scenario
+  {
+    int    submode;
+    int    count;       // of signals
+    double snr;
+    double frequency;   // of the first signal, in Hz
+    double spacing;     // between signals, in Hz
+    double dtSpread;    // maximum start time offset, in seconds
+  };
+
+  // Results of a single decode of a scenario.
+
+  struct Run
+  {
+    std::size_t             decodes;
+    std::size_t             recovered;
+    double                  milliseconds;
+    std::size_t             allocations;
+    std::size_t             allocated;
+    JS8::Event::DecodeStats stats;
+  };
+
+  // Synthesizes the samples for a scenario, adding the messages sent to
+  // the set provided.
+
+  std::vector<std::int16_t>
+  synthesize(Scenario              const & scenario,
+             std::mt19937                & rng,
+             std::set<std::string>       & messages)
+  {
+    auto const nsps      = JS8::Submode::samplesForOneSymbol(scenario.submode);
+    auto const spacing   = JS8::Submode::toneSpacing(scenario.submode);
+    auto const delay     = JS8::Submode::startDelayMS(scenario.submode) / 1000.0;
+    auto const & costas  = JS8::Costas::array(JS8::Submode::costas(scenario.submode));
+
+    // Noise is spread over the Nyquist bandwidth; signal amplitude follows
+    // from the SNR, relative to the portion of it in the SNR bandwidth.
+
+    constexpr double NOISE = 1000.0;
+
+    std::normal_distribution<double>       noise(0.0, NOISE);
+    std::uniform_int_distribution<>        character(0, ALPHABET.size() - 1);
+    std::uniform_real_distribution<double> dt(0.0, scenario.dtSpread);
+
+    double const amplitude = NOISE * std::sqrt(2.0 * SNR_BANDWIDTH / (JS8_RX_SAMPLE_RATE / 2.0)
+                                             * std::pow(10.0, scenario.snr / 10.0));
+
+    std::vector<double> samples(JS8::Submode::samplesPerPeriod(scenario.submode));
+
+    for (auto & sample : samples) sample = noise(rng);
+
+    for (int signal = 0; signal < scenario.count; ++signal)
+    {
+      std::string message(12, ' ');
+
+      for (auto & c : message) c = ALPHABET[character(rng)];
+
+      messages.insert(message);
+
+      std::array<int, JS8_NUM_SYMBOLS> tones;
+
+      JS8::encode(signal % 8, costas, message.data(), tones.data());
+
+      double const frequency = scenario.frequency + signal * scenario.spacing;
+      auto   const start     = static_cast<std::ptrdiff_t>((delay + dt(rng)) * JS8_RX_SAMPLE_RATE);
+      double       phi       = 0.0;
+
+      for (std::size_t symbol = 0; symbol < tones.size(); ++symbol)
+      {
+        double const dphi = 2 * std::numbers::pi * (frequency + tones[symbol] * spacing) / JS8_RX_SAMPLE_RATE;
+
+        for (unsigned int i = 0; i < nsps; ++i, phi += dphi)
+        {
+          auto const j = start + static_cast<std::ptrdiff_t>(symbol * nsps + i);
+
+          if (j >= 0 && j < static_cast<std::ptrdiff_t>(samples.size()))
+          {
+            samples[j] += amplitude * std::sin(phi);
+          }
+        }
+      }
+    }
+
+    std::vector<std::int16_t> result(samples.size());
+
+    std::transform(samples.begin(), samples.end(), result.begin(), [](double const sample)
+    {
+      return static_cast<std::int16_t>(std::clamp(std::round(sample), -32767.0, 32767.0));
+    });
+
+    return result;
+  }
+
+  // Decodes the samples, counting the messages we recovered.
+
+  Run
+  decode(JS8::BufferDecoder                & decoder,
+         JS8::BufferDecoder::Options const & options,
+         std::vector<std::int16_t>   const & samples,
+         std::set<std::string>       const & messages)
+  {
+    std::vector<JS8::Event::Variant> events;
+
+    events.reserve(4096);
+
+    auto const allocationsBefore = allocations.load();
+    auto const allocatedBefore   = allocated  .load();
+    auto const start             = std::chrono::steady_clock::now();
+
+    auto const decodes = decoder.decode(options, samples.data(), samples.size(), events);
+
+    auto const end = std::chrono::steady_clock::now();
+
+    Run run
+    {
+      decodes,
+      0,
+      std::chrono::duration<double, std::milli>(end - start).count(),
+      allocations.load() - allocationsBefore,
+      allocated  .load() - allocatedBefore,
+      {}
+    };
+
+    std::set<std::string_view> recovered;
+
+    for (auto const & event : events)
+    {
+      if (auto const decoded = std::get_if<JS8::Event::Decoded>(&event))
+      {
+        if (auto const it = messages.find(std::string(decoded->text())); it != messages.end())
+        {
+          recovered.insert(*it);
+        }
+      }
+      else if (auto const stats = std::get_if<JS8::Event::DecodeStats>(&event))
+      {
+        run.stats = *stats;
+      }
+    }
+
+    run.recovered = recovered.size();
+
+    return run;
+  }
+
+  // Parse a comma-separated list of numbers.
+
+  template <typename T>
+  std::vector<T>
+  parse(QString const & value)
+  {
+    std::vector<T> result;
+
+    for (auto const & item : value.split(',', Qt::SkipEmptyParts))
+    {
+      result.push_back(static_cast<T>(item.trimmed().toDouble()));
+    }
+
+    return result;
+  }
+}
+
+/******************************************************************************/
+// Main
+/******************************************************************************/
+
+int
+main(int    argc,
+     char * argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  app.setApplicationName("js8bench");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Benchmark the JS8 decoder on synthesized band scenarios.");
+  parser.addHelpOption();
+
+  QCommandLineOption submodeOption   (QStringList {} << "s" << "submodes",
+                                      "Comma-separated list of submodes to benchmark; all by default.",
+                                      "submodes");
+  QCommandLineOption signalsOption   ("signals",    "Comma-separated signal counts.",                "counts",  "1,5,10,20");
+  QCommandLineOption snrOption       ("snr",        "Comma-separated SNRs, in dB.",                  "db",      "-10,-18");
+  QCommandLineOption frequencyOption ("frequency",  "Frequency of the first signal, in Hz.",         "hz",      "500");
+  QCommandLineOption spacingOption   ("spacing",    "Spacing between signals, in Hz.",               "hz",      "100");
+  QCommandLineOption dtOption        ("dt",         "Maximum signal start offset, in seconds.",      "seconds", "1.0");
+  QCommandLineOption iterationsOption("iterations", "Number of times to decode each scenario.",     "count",   "5");
+  QCommandLineOption seedOption      ("seed",       "Random number generator seed.",                 "seed",    "1");
+  QCommandLineOption budgetOption    ("budget",     "Time allowed for each decode, in ms; 0 for none.", "ms",      "0");
+  QCommandLineOption bpOption        ("bp",         "Comma-separated belief propagation rules to compare; sum-product, min-sum, or offset-min-sum.", "rules", "sum-product");
+  QCommandLineOption syncExactOption ("sync-exact", "Sum sync tone power in the Fortran version's order, reproducing its results exactly.");
+  QCommandLineOption checkOption     ("check",      "Check the decoder's waveform tables and sync search, rather than benchmarking.");
+
+  parser.addOptions({submodeOption, signalsOption, snrOption, frequencyOption, spacingOption,
+                     dtOption, iterationsOption, seedOption, budgetOption, bpOption, syncExactOption, checkOption});
+  parser.process(app);
+
+  std::vector<int> submodes;
+
+  if (parser.isSet(submodeOption))
+  {
+    for (auto const & name : parser.value(submodeOption).split(',', Qt::SkipEmptyParts))
+    {
+      auto const it = std::find_if(SUBMODES.begin(), SUBMODES.end(), [&](int const submode)
+      {
+        return JS8::Submode::name(submode).compare(name.trimmed(), Qt::CaseInsensitive) == 0;
+      });
+
+      if (it == SUBMODES.end())
+      {
+        std::cerr << "js8bench: unknown submode " << name.toStdString() << std::endl;
+        return 1;
+      }
+
+      submodes.push_back(*it);
+    }
+  }
+  else
+  {
+    submodes.assign(SUBMODES.begin(), SUBMODES.end());
+  }
+
+  std::vector<std::pair<std::string_view, JS8::BPVariant>> variants;
+
+  for (auto const & name : parser.value(bpOption).split(',', Qt::SkipEmptyParts))
+  {
+    auto const it = std::find_if(BP_VARIANTS.begin(), BP_VARIANTS.end(), [&](auto const & variant)
+    {
+      return name.trimmed().toStdString() == variant.first;
+    });
+
+    if (it == BP_VARIANTS.end())
+    {
+      std::cerr << "js8bench: unknown belief propagation rule " << name.toStdString() << std::endl;
+      return 1;
+    }
+
+    variants.push_back(*it);
+  }
+
+  // Table and sync check; reports the errors found for each submode, and
+  // fails if any of them is out of tolerance.
+
+  if (parser.isSet(checkOption))
+  {
+    bool passed = true;
+
+    for (auto const submode : submodes)
+    {
+      JS8::BufferDecoder decoder(submode);
+
+      auto const tables     = decoder.checkTables();
+      auto const tablesPass = tables.reference <= TABLE_TOLERANCE &&
+                              tables.sync      <= TABLE_TOLERANCE;
+
+      std::printf("{\"submode\":\"%s\",\"check\":\"tables\",\"tolerance\":%g,"
+                  "\"reference\":%g,\"sync\":%g,\"pass\":%s}\n",
+                  JS8::Submode::name(submode).toStdString().c_str(),
+                  TABLE_TOLERANCE,
+                  tables.reference,
+                  tables.sync,
+                  tablesPass ? "true" : "false");
+
+      auto const sync     = decoder.checkSync();
+      auto const syncPass = sync.exact == 0.0 &&
+                            sync.lags  == 0   &&
+                            sync.fast  <= SYNC_TOLERANCE;
+
+      std::printf("{\"submode\":\"%s\",\"check\":\"sync\",\"tolerance\":%g,"
+                  "\"exact\":%g,\"lags\":%d,\"fast\":%g,\"pass\":%s}\n",
+                  JS8::Submode::name(submode).toStdString().c_str(),
+                  SYNC_TOLERANCE,
+                  sync.exact,
+                  sync.lags,
+                  sync.fast,
+                  syncPass ? "true" : "false");
+
+      passed = passed && tablesPass && syncPass;
+    }
+
+    return passed ? 0 : 1;
+  }
+
+  auto const counts     = parse<int>   (parser.value(signalsOption));
+  auto const snrs       = parse<double>(parser.value(snrOption));
+  auto const frequency  = parser.value(frequencyOption).toDouble();
+  auto const spacing    = parser.value(spacingOption).toDouble();
+  auto const dtSpread   = parser.value(dtOption).toDouble();
+  auto const iterations = std::max(1, parser.value(iterationsOption).toInt());
+
+  std::mt19937 rng(parser.value(seedOption).toUInt());
+
+  JS8::BufferDecoder::Options options;
+
+  options.budget    = std::chrono::milliseconds(parser.value(budgetOption).toInt());
+  options.syncExact = parser.isSet(syncExactOption);
+
+  for (auto const submode : submodes)
+  {
+    JS8::BufferDecoder decoder(submode);
+
+    // Warm up; the first decode creates FFT plans and sizes buffers, and
+    // is of no interest here.
+
+    {
+      std::set<std::string> messages;
+      decode(decoder, {}, synthesize({submode, 1, 0.0, frequency, spacing, dtSpread}, rng, messages), messages);
+    }
+
+    for (auto const count : counts)
+    {
+      for (auto const snr : snrs)
+      {
+        Scenario const scenario{submode, count, snr, frequency, spacing, dtSpread};
+
+        // Each rule decodes the same signals, so that they're compared on
+        // equal terms.
+
+        auto const scenarioRng = rng;
+
+        for (auto const & [bpName, bpVariant] : variants)
+        {
+          rng               = scenarioRng;
+          options.bpVariant = bpVariant;
+
+          double      milliseconds    = 0.0;
+          double      minMilliseconds = std::numeric_limits<double>::max();
+          double      maxMilliseconds = 0.0;
+          std::size_t decodes         = 0;
+          std::size_t recovered       = 0;
+          std::size_t sent            = 0;
+          std::size_t runAllocations  = 0;
+          std::size_t runAllocated    = 0;
+
+          JS8::Event::DecodeStats stats{};
+
+          for (int i = 0; i < iterations; ++i)
+          {
+            std::set<std::string> messages;
+
+            auto const samples = synthesize(scenario, rng, messages);
+            auto const run     = decode(decoder, options, samples, messages);
+
+            milliseconds    += run.milliseconds;
+            minMilliseconds  = std::min(minMilliseconds, run.milliseconds);
+            maxMilliseconds  = std::max(maxMilliseconds, run.milliseconds);
+            decodes         += run.decodes;
+            recovered       += run.recovered;
+            sent            += messages.size();
+            runAllocations  += run.allocations;
+            runAllocated    += run.allocated;
+
+            stats.passes       += run.stats.passes;
+            stats.bpIterations += run.stats.bpIterations;
+            stats.bpFailures   += run.stats.bpFailures;
+            stats.crcRejects   += run.stats.crcRejects;
+
+            stats.reducedPasses     += run.stats.reducedPasses;
+            stats.skippedPasses     += run.stats.skippedPasses;
+            stats.skippedCandidates += run.stats.skippedCandidates;
+
+            stats.sync         += run.stats.sync;
+            stats.spectra      += run.stats.spectra;
+            stats.downsample   += run.stats.downsample;
+            stats.demodulate   += run.stats.demodulate;
+            stats.bp           += run.stats.bp;
+            stats.subtract     += run.stats.subtract;
+
+            for (std::size_t pass = 0; pass < stats.candidates.size(); ++pass)
+            {
+              stats.candidates[pass] += run.stats.candidates[pass];
+            }
+          }
+
+          // Stage times are reported as the mean, in milliseconds; counts
+          // as the mean per decode.
+
+          auto const mean = [iterations](auto const value)
+          {
+            if constexpr (std::is_arithmetic_v<decltype(value)>)
+            {
+              return static_cast<double>(value) / iterations;
+            }
+            else
+            {
+              return std::chrono::duration<double, std::milli>(value).count() / iterations;
+            }
+          };
+
+          std::printf("{\"submode\":\"%s\",\"bp\":\"%s\",\"syncExact\":%s,\"signals\":%d,\"snr\":%.1f,\"frequency\":%.1f,\"spacing\":%.1f,"
+                      "\"dt\":%.2f,\"budget\":%lld,\"iterations\":%d,\"sent\":%zu,\"decodes\":%zu,\"recovered\":%zu,"
+                      "\"ms\":{\"mean\":%.3f,\"min\":%.3f,\"max\":%.3f},"
+                      "\"stages\":{\"sync\":%.3f,\"spectra\":%.3f,\"downsample\":%.3f,\"demodulate\":%.3f,\"bp\":%.3f,\"subtract\":%.3f},"
+                      "\"passes\":%.2f,\"candidates\":[%.1f,%.1f,%.1f],"
+                      "\"bpIterations\":%.1f,\"bpFailures\":%.1f,\"crcRejects\":%.1f,"
+                      "\"reducedPasses\":%.2f,\"skippedPasses\":%.2f,\"skippedCandidates\":%.1f,"
+                      "\"allocations\":%.1f,\"allocatedBytes\":%.1f}\n",
+                      JS8::Submode::name(submode).toStdString().c_str(),
+                      std::string(bpName).c_str(),
+                      options.syncExact ? "true" : "false",
+                      count,
+                      snr,
+                      frequency,
+                      spacing,
+                      dtSpread,
+                      static_cast<long long>(options.budget.count()),
+                      iterations,
+                      sent,
+                      decodes,
+                      recovered,
+                      milliseconds / iterations,
+                      minMilliseconds,
+                      maxMilliseconds,
+                      mean(stats.sync),
+                      mean(stats.spectra),
+                      mean(stats.downsample),
+                      mean(stats.demodulate),
+                      mean(stats.bp),
+                      mean(stats.subtract),
+                      mean(stats.passes),
+                      mean(stats.candidates[0]),
+                      mean(stats.candidates[1]),
+                      mean(stats.candidates[2]),
+                      mean(stats.bpIterations),
+                      mean(stats.bpFailures),
+                      mean(stats.crcRejects),
+                      mean(stats.reducedPasses),
+                      mean(stats.skippedPasses),
+                      mean(stats.skippedCandidates),
+                      mean(runAllocations),
+                      mean(runAllocated));
+          std::fflush(stdout);
+        }
+      }
+    }
+  }
+
+  return 0;
+}
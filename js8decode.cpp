@@ -0,0 +1,610 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <QAudioFormat>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QStringList>
+#include "Audio/BWFFile.hpp"
+#include "Channelizer.hpp"
+#include "commons.h"
+#include "FFTWPlans.hpp"
+#include "JS8.hpp"
+#include "JS8Submode.hpp"
+#include "varicode.h"
+
+// Headless batch decoder; decodes 12 kHz mono WAV recordings, writing a
+// JSON object per line to stdout for each decoded frame. Recordings are
+// assumed to start at the start of a period for each submode decoded.
+//
+// Work is split into jobs, each one a period of a file for a submode,
+// which are run in parallel, across files and submodes, by a pool of
+// workers. Files are read one at a time, as the workers need them.
+//
+// Given dial frequencies, files are instead taken to be complex IQ, from
+// a wideband receiver, and are split by a channelizer into a 12 kHz sub-
+// band per dial frequency, each of which is decoded as if it had been a
+// recording. IQ is streamed through the channelizer, and a minute of each
+// sub-band at a time is handed off to the workers, so a file may also be
+// a pipe, as from an SDR, that's read until it's closed.
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+namespace
+{
+  // Submodes that are compiled in, in the order in which we'll decode
+  // them; slower submodes first, as they take the longest.
+
+  constexpr std::array SUBMODES
+  {
+#if JS8_ENABLE_JS8E
+    static_cast<int>(Varicode::JS8CallSlow),
+#endif
+#if JS8_ENABLE_JS8A
+    static_cast<int>(Varicode::JS8CallNormal),
+#endif
+#if JS8_ENABLE_JS8B
+    static_cast<int>(Varicode::JS8CallFast),
+#endif
+#if JS8_ENABLE_JS8C
+    static_cast<int>(Varicode::JS8CallTurbo),
+#endif
+#if JS8_ENABLE_JS8I
+    static_cast<int>(Varicode::JS8CallUltra),
+#endif
+  };
+
+  // Samples of a file, shared by the jobs that decode it; released when
+  // the last of them is done.
+
+  struct File
+  {
+    std::string               name;
+    std::optional<int>        dial;     // of the sub-band, if channelized from IQ
+    std::uint64_t             origin;   // seconds since midnight of the first sample
+    std::size_t               skip = 0; // samples of the recording preceding ours
+    std::vector<std::int16_t> samples;
+  };
+
+  struct Job
+  {
+    std::shared_ptr<File const> file;
+    int                         submode;
+    std::size_t                 start;
+  };
+
+  // Bounded queue of jobs, fed by the main thread and drained by the
+  // workers; bounding it bounds the number of files held in memory.
+
+  class Queue
+  {
+  public:
+
+    explicit Queue(std::size_t const capacity)
+    : m_capacity(capacity)
+    {}
+
+    void
+    push(Job job)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      m_notFull.wait(lock, [this] { return m_jobs.size() < m_capacity; });
+      m_jobs.push_back(std::move(job));
+      m_notEmpty.notify_one();
+    }
+
+    bool
+    pop(Job & job)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      m_notEmpty.wait(lock, [this] { return m_closed || !m_jobs.empty(); });
+
+      if (m_jobs.empty()) return false;
+
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+      m_notFull.notify_one();
+
+      return true;
+    }
+
+    void
+    close()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      m_closed = true;
+      m_notEmpty.notify_all();
+    }
+
+  private:
+
+    std::size_t             m_capacity;
+    std::mutex              m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<Job>         m_jobs;
+    bool                    m_closed = false;
+  };
+
+  // Queue jobs for each period of a file, for each of the submodes.
+
+  void
+  dispatch(Queue                             & queue,
+           std::shared_ptr<File const> const & file,
+           std::vector<int>            const & submodes)
+  {
+    for (auto const submode : submodes)
+    {
+      std::size_t const period = JS8::Submode::samplesPerPeriod(submode);
+
+      for (std::size_t start = 0; start < file->samples.size(); start += period)
+      {
+        queue.push({file, submode, start});
+      }
+    }
+  }
+
+  // Read a file, which must be 12 kHz, mono, and 16-bit; throws if it's
+  // not, or if it can't be read.
+
+  std::shared_ptr<File const>
+  read(QString const & name)
+  {
+    BWFFile file(QAudioFormat{}, name);
+
+    if (!file.open(BWFFile::ReadOnly))
+    {
+      throw std::runtime_error("unable to open file");
+    }
+
+    auto const & format = file.format();
+
+    if (format.sampleRate()   != JS8_RX_SAMPLE_RATE ||
+        format.channelCount() != 1                  ||
+        format.sampleFormat() != QAudioFormat::Int16)
+    {
+      throw std::runtime_error("file must be 12 kHz, mono, 16-bit");
+    }
+
+    auto result = std::make_shared<File>();
+
+    result->name   = name.toStdString();
+    result->origin = file.bext_time_reference() / JS8_RX_SAMPLE_RATE;
+    result->samples.resize(file.size() / sizeof(std::int16_t));
+
+    auto const bytes = static_cast<qint64>(result->samples.size() * sizeof(std::int16_t));
+
+    if (file.read(reinterpret_cast<char *>(result->samples.data()), bytes) != bytes)
+    {
+      throw std::runtime_error("unable to read file");
+    }
+
+    return result;
+  }
+
+  // Channelize interleaved 16-bit IQ from the device provided, until it's
+  // exhausted, dispatching each minute of each dial frequency's sub-band
+  // as it's completed, and whatever remains of them at the end. Throws if
+  // the sample rate or dial frequencies aren't usable, or on a read error.
+
+  void
+  skim(QIODevice                & device,
+       std::string        const & name,
+       unsigned           const   rate,
+       std::uint64_t      const   origin,
+       std::vector<int>   const & dials,
+       std::vector<int>   const & submodes,
+       Queue                    & queue)
+  {
+    Channelizer channelizer(rate, dials);
+
+    // A minute of the sub-band of a dial frequency, which it fills as IQ
+    // is channelized, and which is handed off once full.
+
+    auto const block = [&](int           const dial,
+                           std::uint64_t const seconds,
+                           std::size_t   const skip)
+    {
+      auto file = std::make_shared<File>();
+
+      file->name   = name;
+      file->dial   = dial;
+      file->origin = seconds;
+      file->skip   = skip;
+      file->samples.reserve(JS8_RX_SAMPLE_SIZE);
+
+      return file;
+    };
+
+    std::vector<std::shared_ptr<File>> blocks;
+
+    for (auto const dial : dials) blocks.push_back(block(dial, origin, 0));
+
+    // Reads may come up short of a whole frame when reading from a pipe;
+    // any partial frame is carried over to the next read.
+
+    constexpr std::size_t FRAME = 2 * sizeof(std::int16_t);
+
+    std::vector<std::int16_t>          buffer(rate / 10 * 2);
+    std::vector<std::complex<float>>   iq;
+    std::vector<std::vector<float>>    outputs;
+    std::size_t                        held = 0;
+
+    auto const bytes = buffer.size() * sizeof(std::int16_t);
+    auto const data  = reinterpret_cast<char *>(buffer.data());
+
+    for (qint64 got; (got = device.read(data + held, static_cast<qint64>(bytes - held))) != 0;)
+    {
+      if (got < 0) throw std::runtime_error("unable to read file");
+
+      held += static_cast<std::size_t>(got);
+
+      auto const frames = held / FRAME;
+
+      iq.resize(frames);
+
+      for (std::size_t i = 0; i < frames; ++i)
+      {
+        iq[i] = {static_cast<float>(buffer[2 * i]),
+                 static_cast<float>(buffer[2 * i + 1])};
+      }
+
+      held -= frames * FRAME;
+      std::memmove(data, data + frames * FRAME, held);
+
+      for (auto & output : outputs) output.clear();
+
+      channelizer.process(iq.data(), frames, outputs);
+
+      for (std::size_t d = 0; d < dials.size(); ++d)
+      {
+        for (auto const sample : outputs[d])
+        {
+          auto & file = blocks[d];
+
+          file->samples.push_back(static_cast<std::int16_t>(std::clamp(std::lround(sample), -32767L, 32767L)));
+
+          if (file->samples.size() == JS8_RX_SAMPLE_SIZE)
+          {
+            dispatch(queue, file, submodes);
+            file = block(dials[d],
+                         file->origin + JS8_NTMAX,
+                         file->skip   + JS8_RX_SAMPLE_SIZE);
+          }
+        }
+      }
+    }
+
+    for (auto const & file : blocks)
+    {
+      if (!file->samples.empty()) dispatch(queue, file, submodes);
+    }
+  }
+
+  // Append a string to the output, quoted and escaped as a JSON string.
+
+  void
+  quote(std::string       & out,
+        std::string_view    value)
+  {
+    out += '"';
+
+    for (unsigned char const c : value)
+    {
+      switch (c)
+      {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n";  break;
+        case '\r': out += "\\r";  break;
+        case '\t': out += "\\t";  break;
+        default:
+          if (c < 0x20)
+          {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+            out += escape;
+          }
+          else
+          {
+            out += static_cast<char>(c);
+          }
+      }
+    }
+
+    out += '"';
+  }
+
+  // Format a decoded event as a line of JSON.
+
+  std::string
+  format(Job                 const & job,
+         JS8::Event::Decoded const & decoded)
+  {
+    std::string line = "{\"file\":";
+
+    quote(line, job.file->name);
+
+    char fields[256];
+
+    if (job.file->dial)
+    {
+      std::snprintf(fields, sizeof(fields), ",\"dial\":%d", *job.file->dial);
+      line += fields;
+    }
+
+    std::snprintf(fields, sizeof(fields),
+                  ",\"offset\":%.1f,\"submode\":",
+                  static_cast<double>(job.file->skip + job.start) / JS8_RX_SAMPLE_RATE);
+    line += fields;
+
+    quote(line, JS8::Submode::name(job.submode).toStdString());
+
+    std::snprintf(fields, sizeof(fields),
+                  ",\"utc\":%d,\"snr\":%d,\"xdt\":%.3f,\"frequency\":%.3f,\"data\":",
+                  decoded.utc,
+                  decoded.snr,
+                  decoded.xdt,
+                  decoded.frequency);
+    line += fields;
+
+    quote(line, decoded.text());
+
+    std::snprintf(fields, sizeof(fields),
+                  ",\"type\":%d,\"quality\":%.3f,\"mode\":%d}\n",
+                  decoded.type,
+                  decoded.quality,
+                  decoded.mode);
+    line += fields;
+
+    return line;
+  }
+
+  // Worker; decodes jobs until the queue is closed and empty. Decoders
+  // are created as required, one per submode, and reused.
+
+  void
+  work(Queue                            & queue,
+       JS8::BufferDecoder::Options const & options,
+       std::mutex                       & outputMutex)
+  {
+    std::map<int, JS8::BufferDecoder> decoders;
+    std::vector<JS8::Event::Variant>  events;
+    Job                               job;
+
+    while (queue.pop(job))
+    {
+      auto & decoder = decoders.try_emplace(job.submode, job.submode).first->second;
+
+      // Time of the start of the period, in the same format as the
+      // decoder uses for live decodes.
+
+      auto const seconds = (job.file->origin + job.start / JS8_RX_SAMPLE_RATE) % 86400;
+      auto       jobOptions = options;
+
+      jobOptions.utc = code_time(seconds / 3600,
+                                 seconds / 60 % 60,
+                                 seconds % 60);
+
+      events.clear();
+
+      decoder.decode(jobOptions,
+                     job.file->samples.data() + job.start,
+                     job.file->samples.size() - job.start,
+                     events);
+
+      std::string output;
+
+      for (auto const & event : events)
+      {
+        if (auto const decoded = std::get_if<JS8::Event::Decoded>(&event))
+        {
+          output += format(job, *decoded);
+        }
+      }
+
+      if (!output.empty())
+      {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::fwrite(output.data(), 1, output.size(), stdout);
+        std::fflush(stdout);
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+// Main
+/******************************************************************************/
+
+int
+main(int    argc,
+     char * argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  app.setApplicationName("js8decode");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Decode JS8 frames from 12 kHz mono WAV recordings, or from sub-bands of IQ recordings.");
+  parser.addHelpOption();
+
+  QCommandLineOption submodeOption(QStringList {} << "s" << "submodes",
+                                   "Comma-separated list of submodes to decode; all by default.",
+                                   "submodes");
+  QCommandLineOption jobsOption   (QStringList {} << "j" << "jobs",
+                                   "Number of decodes to run in parallel.",
+                                   "jobs",
+                                   QString::number(std::max(1u, std::thread::hardware_concurrency())));
+  QCommandLineOption fqsoOption   ("fqso", "QSO frequency, in Hz.",         "hz", "1500");
+  QCommandLineOption faOption     ("fa",   "Low decode limit, in Hz.",      "hz", "0");
+  QCommandLineOption fbOption     ("fb",   "High decode limit, in Hz.",     "hz", "5000");
+  QCommandLineOption wisdomOption ("wisdom", "FFTW wisdom file to use and update.", "file");
+  QCommandLineOption dialsOption  ("dials",
+                                   "Comma-separated list of dial frequencies, in Hz relative to the center of the IQ "
+                                   "passband, of sub-bands to decode; files are then taken to be stereo WAV IQ, "
+                                   "at a multiple of 24 kHz, or '-' for raw interleaved 16-bit IQ on standard input.",
+                                   "hz");
+  QCommandLineOption rateOption   ("rate", "Sample rate of IQ on standard input, in Hz.", "hz", "192000");
+  QCommandLineOption exactOption  ("sync-exact", "Sum sync tone power in the Fortran version's order, reproducing its results exactly.");
+
+  parser.addOptions({submodeOption, jobsOption, fqsoOption, faOption, fbOption, wisdomOption, dialsOption, rateOption, exactOption});
+  parser.addPositionalArgument("files", "WAV files, or IQ sources, to decode.", "files...");
+  parser.process(app);
+
+  auto const files = parser.positionalArguments();
+
+  if (files.isEmpty()) parser.showHelp(1);
+
+  // Determine the submodes to decode.
+
+  std::vector<int> submodes;
+
+  if (parser.isSet(submodeOption))
+  {
+    for (auto const & name : parser.value(submodeOption).split(',', Qt::SkipEmptyParts))
+    {
+      auto const it = std::find_if(SUBMODES.begin(), SUBMODES.end(), [&](int const submode)
+      {
+        return JS8::Submode::name(submode).compare(name.trimmed(), Qt::CaseInsensitive) == 0;
+      });
+
+      if (it == SUBMODES.end())
+      {
+        std::cerr << "js8decode: unknown submode " << name.toStdString() << std::endl;
+        return 1;
+      }
+
+      submodes.push_back(*it);
+    }
+  }
+  else
+  {
+    submodes.assign(SUBMODES.begin(), SUBMODES.end());
+  }
+
+  // Determine the dial frequencies of IQ sub-bands, if any.
+
+  std::vector<int> dials;
+
+  if (parser.isSet(dialsOption))
+  {
+    for (auto const & value : parser.value(dialsOption).split(',', Qt::SkipEmptyParts))
+    {
+      bool       ok;
+      auto const dial = value.trimmed().toInt(&ok);
+
+      if (!ok)
+      {
+        std::cerr << "js8decode: invalid dial frequency " << value.toStdString() << std::endl;
+        return 1;
+      }
+
+      dials.push_back(dial);
+    }
+  }
+
+  JS8::BufferDecoder::Options options;
+
+  options.nfqso = parser.value(fqsoOption).toInt();
+  options.nfa   = parser.value(faOption).toInt();
+  options.nfb   = parser.value(fbOption).toInt();
+
+  options.syncExact = parser.isSet(exactOption);
+
+  auto const jobs = std::max(1, parser.value(jobsOption).toInt());
+
+  if (parser.isSet(wisdomOption)) FFTW::start(parser.value(wisdomOption).toLocal8Bit().constData());
+
+  // Start the workers, then feed them jobs, a file at a time.
+
+  Queue                    queue(jobs * 4);
+  std::mutex               outputMutex;
+  std::vector<std::thread> workers;
+
+  for (int i = 0; i < jobs; ++i)
+  {
+    workers.emplace_back(work, std::ref(queue), std::cref(options), std::ref(outputMutex));
+  }
+
+  int result = 0;
+
+  for (auto const & name : files)
+  {
+    try
+    {
+      if (dials.empty())
+      {
+        dispatch(queue, read(name), submodes);
+      }
+      else if (name == "-")
+      {
+        QFile input;
+
+        if (!input.open(stdin, QIODevice::ReadOnly))
+        {
+          throw std::runtime_error("unable to open standard input");
+        }
+
+        skim(input, "-", parser.value(rateOption).toUInt(), 0, dials, submodes, queue);
+      }
+      else
+      {
+        BWFFile input(QAudioFormat{}, name);
+
+        if (!input.open(BWFFile::ReadOnly))
+        {
+          throw std::runtime_error("unable to open file");
+        }
+
+        auto const & format = input.format();
+
+        if (format.channelCount() != 2 ||
+            format.sampleFormat() != QAudioFormat::Int16)
+        {
+          throw std::runtime_error("IQ file must be stereo, 16-bit");
+        }
+
+        auto const rate = static_cast<unsigned>(format.sampleRate());
+
+        skim(input, name.toStdString(), rate, input.bext_time_reference() / rate, dials, submodes, queue);
+      }
+    }
+    catch (std::exception const & e)
+    {
+      std::cerr << "js8decode: " << name.toStdString() << ": " << e.what() << std::endl;
+      result = 1;
+    }
+  }
+
+  queue.close();
+
+  for (auto & worker : workers) worker.join();
+
+  if (parser.isSet(wisdomOption)) FFTW::stop();
+
+  return result;
+}
@@ -73,6 +73,7 @@
 #include "Inbox.h"
 #include "messagewindow.h"
 #include "NotificationAudio.h"
+#include "JS8Snapshot.hpp"
 #include "JS8Submode.hpp"
 #include "EventFilter.hpp"
 #include "Geodesic.hpp"
@@ -80,6 +81,7 @@
 #include "ui_mainwindow.h"
 #include "moc_mainwindow.cpp"
 
+Q_DECLARE_LOGGING_CATEGORY(decoderstats_js8)
 Q_DECLARE_LOGGING_CATEGORY(mainwindow_js8)
 
 //TODO: Move to member:
@@ -96,9 +98,7 @@ constexpr quint32 UI_POLL_INTERVAL_MS = 100;
 constexpr int TX_SWITCHOFF_DELAY = 200;
 
 int volatile    itone[JS8_NUM_SYMBOLS];  // Audio tones for all Tx symbols
-struct dec_data dec_data;                // for sharing with Fortran
 struct specData specData;                // Used by plotter
-std::mutex      fftw_mutex;
 
 namespace
 {
@@ -334,7 +334,7 @@ MainWindow::MainWindow(QString  const & program_info,
   // no parent so that it has a taskbar icon
   m_logDlg (new LogQSO (program_title (), m_settings, &m_config, nullptr)),
   m_lastDialFreq {0},
-  m_detector {new Detector {JS8_RX_SAMPLE_RATE, JS8_NTMAX}},
+  m_detector {new Detector {dec_data, JS8_RX_SAMPLE_RATE, JS8_NTMAX}},
   m_FFTSize {6912 / 2},         // conservative value to avoid buffer overruns
   m_soundInput {new SoundInput},
   m_modulator {new Modulator},
@@ -342,7 +342,7 @@ MainWindow::MainWindow(QString  const & program_info,
   m_notification {new NotificationAudio},
   m_cq_loop {new TxLoop {"CQ calls"}},
   m_hb_loop {new TxLoop {"HB calls"}},
-  m_decoder {this},
+  m_decoder {dec_data, this},
   m_secBandChanged {0},
   m_freqNominal {0},
   m_freqTxNominal {0},
@@ -710,16 +710,14 @@ MainWindow::MainWindow(QString  const & program_info,
   displayDialFrequency();
   readSettings();            //Restore user's setup params
 
-  {
-    std::lock_guard<std::mutex> lock(fftw_mutex);
-    fftwf_import_wisdom_from_filename(wisdomFileName());
-  }
+  FFTW::start(wisdomFileName());
 
   m_networkThread.start(m_networkThreadPriority);
   m_audioThread.start (m_audioThreadPriority);
   m_notificationAudioThread.start(m_notificationAudioThreadPriority);
   m_decoder.start(m_decoderThreadPriority);
 
+  setSecondaryReceiver(AudioDevice::Both == m_config.audio_input_channel ());
   Q_EMIT startAudioInputStream (m_config.audio_input_device (), m_framesAudioInputBuffered, m_detector, m_config.audio_input_channel ());
   Q_EMIT initializeAudioOutputStream (m_config.audio_output_device (), AudioDevice::Mono == m_config.audio_output_channel () ? 1 : 2, m_msAudioOutputBuffered);
   Q_EMIT initializeNotificationAudioOutputStream(m_config.notification_audio_output_device(), m_msAudioOutputBuffered);
@@ -2079,10 +2077,11 @@ void MainWindow::manualBandHop(const StationList::Station station)
 //--------------------------------------------------- MainWindow destructor
 MainWindow::~MainWindow()
 {
-  {
-    std::lock_guard<std::mutex> lock(fftw_mutex);
-    fftwf_export_wisdom_to_filename(wisdomFileName());
-  }
+  // The secondary decoder must be done with its capture buffer before
+  // the audio thread takes the detector, and with it the buffer, away.
+  setSecondaryReceiver(false);
+
+  FFTW::stop();
 
   m_networkThread.quit();
   m_networkThread.wait();
@@ -2333,6 +2332,85 @@ void MainWindow::set_application_font (QFont const& font)
 }
 
 
+//-------------------------------------------------- setSecondaryReceiver()
+// Create the secondary receiver, i.e., its capture buffer, detector, and
+// decoder, or destroy them, according to whether it's wanted. The capture
+// buffer and decoder thread cost several megabytes and a thread apiece,
+// and the detector a DSP thread, so we have them only while decoding the
+// other channel of a stereo input.
+//
+// The primary detector feeds the secondary on the audio thread, so the
+// secondary detector is destroyed there, once the primary has let go of
+// it, and its capture buffer along with it; the decoder reads from the
+// buffer, so it's stopped before either goes.
+void MainWindow::setSecondaryReceiver(bool const enabled)
+{
+  if (enabled == static_cast<bool>(m_secondaryDetector)) return;
+
+  m_secondaryDecoderBusy = false;
+  m_secondaryK0          = 0;
+
+  if (enabled)
+  {
+    m_secondaryCapture.reset(new JS8::Capture {});
+    m_secondaryDetector = new Detector {*m_secondaryCapture, JS8_RX_SAMPLE_RATE, JS8_NTMAX};
+    m_secondaryDetector->setBlockSize(m_FFTSize);
+    m_secondaryDetector->moveToThread(&m_audioThread);
+
+    connect(m_secondaryDetector, &Detector::framesWritten, this, &MainWindow::secondaryDataSink);
+    connect(this, &MainWindow::FFTSize, m_secondaryDetector, &Detector::setBlockSize);
+    connect(&m_audioThread, &QThread::finished, m_secondaryDetector, &QObject::deleteLater);
+
+    m_secondaryDecoder.reset(new JS8::Decoder {*m_secondaryCapture});
+    m_secondaryDecoder->setSubmodes(decodeSubmodes());
+
+    connect(m_secondaryDecoder.data(), &JS8::Decoder::decodeEvent, this, &MainWindow::processSecondaryDecodeEvent);
+
+    m_secondaryDecoder->start(m_decoderThreadPriority);
+    m_detector->setSecondary(m_secondaryDetector);
+  }
+  else
+  {
+    m_detector->setSecondary(nullptr);
+
+    m_secondaryDecoder->quit();
+    m_secondaryDecoder.reset();
+
+    connect(m_secondaryDetector, &QObject::destroyed, [capture = m_secondaryCapture.take()]
+    {
+      delete capture;
+    });
+
+    m_secondaryDetector->deleteLater();
+    m_secondaryDetector = nullptr;
+  }
+
+  qCDebug(mainwindow_js8) << "secondary receiver" << (enabled ? "created" : "destroyed");
+}
+
+//----------------------------------------------------- secondaryDataSink()
+// The secondary receiver has no spectrum display; all we need do is clear
+// what remains of the previous period from its capture buffer when a new
+// one starts, as dataSink() does for the primary. This is queued from the
+// detector's thread, which may have written more since, so we clear from
+// where it's gotten to, rather than from where it was. Anything queued by
+// a detector that's since been destroyed is ignored.
+void MainWindow::secondaryDataSink(qint64 frames)
+{
+    if (!m_secondaryDetector || sender() != m_secondaryDetector) return;
+
+    if (frames < m_secondaryK0)
+    {
+        QMutexLocker mutex(m_secondaryDetector->getMutex());
+
+        auto const kin = m_secondaryCapture->params.kin;
+
+        JS8::clear(*m_secondaryCapture, kin, JS8_RX_SAMPLE_SIZE - kin);
+    }
+
+    m_secondaryK0 = frames;
+}
+
 //-------------------------------------------------------------- dataSink()
 void MainWindow::dataSink(qint64 frames)
 {
@@ -2385,8 +2463,7 @@ void MainWindow::dataSink(qint64 frames)
         ja = 0;
         ssum.fill(0.0f);
         m_ihsym = 0;
-        std::fill(std::begin(dec_data.d2) + k,
-                  std::end  (dec_data.d2),  0);
+        JS8::clear(dec_data, k, JS8_RX_SAMPLE_SIZE - k);
       }
 
       float gain  = pow(10.0f, 0.1f * m_inGain);
@@ -2395,7 +2472,7 @@ void MainWindow::dataSink(qint64 frames)
 
       for (int i = k0; i < k; ++i)
       {
-        float x1 = dec_data.d2[i];
+        float x1 = dec_data.d2[JS8::locate(dec_data, i)];
         pxmax    = std::max(pxmax, fabs(x1));
         sq      += x1 * x1;
       }
@@ -2406,63 +2483,56 @@ void MainWindow::dataSink(qint64 frames)
       k0  = k;
       ja += jstep;
 
-      // Perform real to complex FFT; note that the Fortran code performed
-      // this operation in the four2a subroutine, which contains a cache
-      // of plans. However, since the FFTW3 library itself caches, this
-      // resulted in double caching, so as an experiment we're allowing
-      // the library to handle caching.
-      //
-      // Note that the FFTW library requires all calls but for the plan
-      // execution, i.e., fftwf_execute(), to be serialized. The library
-      // doesn't require prescriptive serialization, anything will do so
-      // long as the result is one thread at a time.
+      // Perform real to complex FFT. The Fortran code performed this in
+      // the four2a subroutine, which contained a cache of plans; we hold
+      // onto a plan and its storage here instead, creating them the first
+      // time through. The plan comes from the planning service, which will
+      // measure the problem in the background and hand us a better plan
+      // when it can; refreshing is cheap if there's nothing new.
       //
       // Providing room for an extra complex value, i.e., a pair of floats,
       // real and imaginary parts, allows us to use the same buffer for the
-      // FFT input and output.
-      //
-      // While the memory for the FFT can come from anywhere, if we ask the
-      // library for it, it'll guarantee that it's aligned for use of SIMD
-      // instructions, which will in turn allow it to use them.
+      // FFT input and output. While the memory for the FFT can come from
+      // anywhere, if we ask the library for it, it'll guarantee that it's
+      // aligned for use of SIMD instructions, which will in turn allow it
+      // to use them.
 
-      fftwf_complex * fftw_complex;
-      float         * fftw_real;
-      fftwf_plan      fftw_plan;
+      if (!m_spectrumPlan)
       {
-        std::lock_guard<std::mutex> lock(fftw_mutex);
-
-        fftw_complex = fftwf_alloc_complex(nfft3 / 2 + 1);
+        m_spectrumData.reset(fftwf_alloc_complex(nfft3 / 2 + 1));
 
-        if (!fftw_complex)
+        if (!m_spectrumData)
         {
           throw std::runtime_error("Failed to allocate FFT data");
         }
 
-        fftw_real = reinterpret_cast<float *>(fftw_complex);
-        fftw_plan = fftwf_plan_dft_r2c_1d(nfft3,
-                                          fftw_real,
-                                          fftw_complex,
-                                          FFTW_ESTIMATE_PATIENT);
+        m_spectrumPlan = FFTW::Plan(FFTW::Problem{FFTW::Problem::Kind::R2C, nfft3},
+                                    m_spectrumData.get(),
+                                    m_spectrumData.get());
 
-        if (!fftw_plan)
+        if (!m_spectrumPlan)
         {
-          fftwf_free(fftw_complex);
           throw std::runtime_error("Failed to create FFT plan");
         }
       }
 
+      m_spectrumPlan.refresh();
+
+      auto const fftw_complex = m_spectrumData.get();
+      auto const fftw_real    = reinterpret_cast<float *>(fftw_complex);
+
       // Copy data and apply the window, then execute the FFT.
 
       for (int i = 0; i < nfft3; ++i)
       {
-        if (int j  = ja + i - nfft3;
-                j >= 0 &&
-                j < NMAX) fftw_real[i] = 0.1f * dec_data.d2[j];
+        int const j = ja + i - nfft3;
+
+        fftw_real[i] = (j >= 0 && j < NMAX) ? 0.1f * dec_data.d2[JS8::locate(dec_data, j)] : 0.0f;
       }
 
       ++m_ihsym;
 
-      fftwf_execute(fftw_plan);
+      fftwf_execute(m_spectrumPlan);
 
       // Process the resulting spectrum.
 
@@ -2479,16 +2549,6 @@ void MainWindow::dataSink(qint64 frames)
         s[i]          = 1000.0f * gain * sx;
       }
 
-      // We're now done with the plan and the FFT storage. Even though
-      // the plan is being 'destroyed' here, the library will cache it
-      // at its discretion. As above, the calls must be serialized.
-
-      {
-        std::lock_guard<std::mutex> lock(fftw_mutex);
-        fftwf_destroy_plan(fftw_plan);
-        fftwf_free(fftw_complex);
-      }
-
       // Update average spectra.
 
       for (int i = 0; i < iz; ++i) specData.savg[i] = ssum[i] / m_ihsym;
@@ -2878,6 +2938,7 @@ void MainWindow::openSettings(int tab){
         }
 
         if(m_config.restart_audio_input () && !m_config.audio_input_device ().isNull ()) {
+            setSecondaryReceiver(AudioDevice::Both == m_config.audio_input_channel ());
             Q_EMIT startAudioInputStream (m_config.audio_input_device(),
                                           m_framesAudioInputBuffered,
                                           m_detector,
@@ -3392,8 +3453,14 @@ bool MainWindow::decode(qint32 k){
         return false;
     }
 
-    if(m_decoderBusyStartTime.isValid() && m_decoderBusyStartTime.msecsTo(QDateTime::currentDateTimeUtc()) < 1000){
+    // a window that's just received a full transmission shouldn't wait on the pause
+    bool const complete = std::any_of(m_decoderQueue.cbegin(), m_decoderQueue.cend(), [](DecodeParams const & d){
+        return d.complete;
+    });
+
+    if(!complete && m_decoderBusyStartTime.isValid() && m_decoderBusyStartTime.msecsTo(QDateTime::currentDateTimeUtc()) < 1000){
         qCDebug(decoder_js8) << "--> decoder paused for 1000 ms after last decode start";
+        decodePrime(k);
         return false;
     }
 
@@ -3407,6 +3474,7 @@ bool MainWindow::decode(qint32 k){
 
     qint32 submode = -1;
     if(!decodeProcessQueue(&submode)){
+        decodePrime(k);
         return false;
     }
 
@@ -3415,6 +3483,59 @@ bool MainWindow::decode(qint32 k){
     return true;
 }
 
+/**
+ * @brief MainWindow::decodePrime
+ *        while the decoder is idle, let it get a head start on the
+ *        decodes to come, by providing it with what's been captured
+ *        so far of the current period of each submode to be decoded
+ * @param k - the current frame count
+ */
+void MainWindow::decodePrime(qint32 k){
+    // submodes, and their decode submode bits
+    static constexpr std::array<std::pair<int, std::size_t>, JS8_ENABLE_JS8I ? 5 : 4> submodes = {{
+        {Varicode::JS8CallNormal, 0},
+        {Varicode::JS8CallFast,   1},
+        {Varicode::JS8CallTurbo,  2},
+        {Varicode::JS8CallSlow,   3},
+#if JS8_ENABLE_JS8I
+        {Varicode::JS8CallUltra,  4},
+#endif
+    }};
+
+    // critical section
+    QMutexLocker mutex(m_detector->getMutex());
+
+    if(m_decoderBusy){
+        return;
+    }
+
+    bool multi = ui->actionModeMultiDecoder->isChecked();
+
+    std::array<std::pair<int, int>, 5> spans = {};
+
+    for(auto const & [submode, shift] : submodes){
+        if(!multi && submode != m_nSubMode){
+            continue;
+        }
+
+        qint32 const cycleFrames = JS8::Submode::samplesPerPeriod(submode);
+        qint32 const start       = JS8::Submode::computeCycleForDecode(submode, k) * cycleFrames;
+        qint32       ready       = k - start;
+        if(ready < 0){
+            ready += JS8_RX_SAMPLE_SIZE;
+        }
+
+        spans[shift] = {start, ready};
+    }
+
+    m_decoder.prime(spans);
+
+    if(auto const secondary = m_detector->secondary()){
+        QMutexLocker secondaryMutex(secondary->getMutex());
+        m_secondaryDecoder->prime(spans);
+    }
+}
+
 /**
  * @brief MainWindow::decodeEnqueueReady
  *        compute the available decoder ranges that can be processed and
@@ -3612,6 +3733,13 @@ bool MainWindow::decodeEnqueueReadyExperiment(qint32 k, qint32 /*k0*/){
             }
             qCDebug(decoder_js8) << JS8::Submode::name(submode) << "alt" << alt << "cycle" << cycle << "cycle frames" << cycleFrames << "cycle start" << cycle*cycleFrames << "cycle end" << (cycle+1)*cycleFrames << "k" << k << "frames ready" << cycleFramesReady << "incremeted by" << incrementedBy;
 
+            // a transmission that started on time has been received in full once we have
+            // its symbols past the start delay; decode the moment we get there, rather than
+            // waiting on the next interval, as that's the decode most likely to succeed
+            qint32 const cycleFramesComplete = cycleFramesNeeded + (qint32)JS8::Submode::startDelayMS(submode) * oneSecondSamples / 1000;
+            bool   const completed           = cycleFramesReady - incrementedBy < cycleFramesComplete &&
+                                               cycleFramesReady                 >= cycleFramesComplete;
+
             if(everySecond && incrementedBy >= oneSecondSamples){
                 DecodeParams d;
                 d.submode = submode;
@@ -3626,6 +3754,18 @@ bool MainWindow::decodeEnqueueReadyExperiment(qint32 k, qint32 /*k0*/){
                 // keep track of last decode position
                 m_lastDecodeStartMap[submode] = k;
             }
+            else if(!everySecond && completed){
+                DecodeParams d;
+                d.submode = submode;
+                d.start = cycle*cycleFrames;
+                d.sz = cycleFramesReady;
+                d.complete = true;
+                m_decoderQueue.append(d);
+                decodes++;
+
+                // keep track of last decode position
+                m_lastDecodeStartMap[submode] = k;
+            }
             else if(
                 (incrementedBy >= 1.5*oneSecondSamples && cycleFramesReady >= cycleFramesNeeded)                        || // within every 3/2 seconds for normal positions
                 (incrementedBy >= oneSecondSamples     && cycleFramesReady >= cycleFramesNeeded - 1.5*oneSecondSamples) || // within the last 3/2 seconds of a new cycle
@@ -3798,6 +3938,30 @@ void MainWindow::decodeStart()
                        << " --> I:" << dec_data.params.kposI << dec_data.params.kposI + dec_data.params.kszI << QString("(%1)").arg(dec_data.params.kszI);
 
   m_decoder.decode();
+
+  // The secondary receiver decodes the same spans of its own capture
+  // buffer; it's fed by the same stream, so the two are aligned. It's
+  // got a decoder of its own, which may still be busy with the previous
+  // run; if so, it sits this one out, as does the primary when busy.
+
+  if (auto const secondary = m_detector->secondary();
+                 secondary && !m_secondaryDecoderBusy)
+  {
+    QMutexLocker secondaryMutex(secondary->getMutex());
+
+    auto &     params = m_secondaryCapture->params;
+    auto const kin    = params.kin;
+    auto const origin = params.origin;
+    auto const epoch  = params.epoch;
+
+    params        = dec_data.params;
+    params.kin    = kin;
+    params.origin = origin;
+    params.epoch  = epoch;
+
+    m_secondaryDecoderBusy = true;
+    m_secondaryDecoder->decode();
+  }
 }
 
 /**
@@ -3840,6 +4004,11 @@ MainWindow::decodeDone()
     return it.second.secsTo(QDateTime::currentDateTimeUtc()) > JS8::Submode::period(it.first.submode);
   });
 
+  std::erase_if(m_secondaryDupeCache, [](auto const & it)
+  {
+    return it.second.secsTo(QDateTime::currentDateTimeUtc()) > JS8::Submode::period(it.first.submode);
+  });
+
   decodeBusy(false);
 }
 
@@ -3870,6 +4039,52 @@ QList<int> generateOffsets(int minOffset, int maxOffset){
     return offsets;
 }
 
+/**
+ * @brief MainWindow::processSecondaryDecodeEvent
+ *        frames decoded by the secondary receiver are from another band,
+ *        so they're kept out of this one's activity; unique frames are
+ *        logged to ALL.TXT, marked as having come from the secondary,
+ *        along with its dial frequency;
+ *        the end of a run marks the secondary decoder as no longer busy
+ * @param event - the decoder event
+ */
+void
+MainWindow::processSecondaryDecodeEvent(JS8::Event::Variant const & event)
+{
+  if (std::holds_alternative<JS8::Event::DecodeFinished>(event))
+  {
+    m_secondaryDecoderBusy = false;
+    return;
+  }
+
+  auto const decoded = std::get_if<JS8::Event::Decoded>(&event);
+
+  if (!decoded) return;
+
+  DecodedText   decodedtext(*decoded);
+  FrameCacheKey dedupeKey(decodedtext.submode(),
+                          decodedtext.frame());
+
+  if (auto const it  = m_secondaryDupeCache.find(dedupeKey);
+                 it != m_secondaryDupeCache.end() &&
+                 it->second.secsTo(QDateTime::currentDateTimeUtc()) < 0.5 * JS8::Submode::period(decodedtext.submode()))
+  {
+    return;
+  }
+
+  m_secondaryDupeCache.insert_or_assign(dedupeKey, QDateTime::currentDateTimeUtc());
+
+  qCDebug(mainwindow_js8) << "secondary" << JS8::Submode::name(decodedtext.submode()) << "decoded text" << decodedtext.message();
+
+  // ALL.TXT band headers are the primary's, so we carry our own dial
+  // frequency on each line, if it's been configured.
+
+  auto date = DriftingDateTime::currentDateTimeUtc().toString("yyyy-MM-dd");
+  auto const freq = m_config.secondary_dial_frequency();
+  auto const dial = freq ? QString::number(freq / 1.e6, 'f', 6) : QString("?");
+  writeAllTxt(date + " RX2 " + dial + " MHz " + decodedtext.string() + " " + decodedtext.message());
+}
+
 void
 MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
 {
@@ -3917,10 +4132,75 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
           }
         }
       }
+      else if constexpr (std::is_same_v<T, JS8::Event::DecodeStats>)
+      {
+        qCDebug(decoderstats_js8) << JS8::Submode::name(e.mode)
+                                  << "passes"        << e.passes
+                                  << "candidates"    << e.candidates[0] << e.candidates[1] << e.candidates[2]
+                                  << "bp iterations" << e.bpIterations
+                                  << "bp failures"   << e.bpFailures
+                                  << "crc rejects"   << e.crcRejects
+                                  << "reduced"       << e.reducedPasses
+                                  << "skipped"       << e.skippedPasses << e.skippedCandidates
+                                  << "known"         << e.knownCandidates
+                                  << "sync"          << e.sync.count()       << "us"
+                                  << "spectra"       << e.spectra.count()    << "us"
+                                  << "downsample"    << e.downsample.count() << "us"
+                                  << "demodulate"    << e.demodulate.count() << "us"
+                                  << "bp"            << e.bp.count()         << "us"
+                                  << "subtract"      << e.subtract.count()   << "us"
+                                  << "total"         << e.total.count()      << "us";
+
+        if (canSendNetworkMessage())
+        {
+          sendNetworkMessage("DECODE.STATS", "", {
+              {"_ID", QVariant(-1)},
+              {"SUBMODE", QVariant(e.mode)},
+              {"PASSES", QVariant(e.passes)},
+              {"CANDIDATES", QVariantList{e.candidates[0], e.candidates[1], e.candidates[2]}},
+              {"BP_ITERATIONS", QVariant(e.bpIterations)},
+              {"BP_FAILURES", QVariant(e.bpFailures)},
+              {"CRC_REJECTS", QVariant(e.crcRejects)},
+              {"REDUCED_PASSES", QVariant(e.reducedPasses)},
+              {"SKIPPED_PASSES", QVariant(e.skippedPasses)},
+              {"SKIPPED_CANDIDATES", QVariant(e.skippedCandidates)},
+              {"KNOWN_CANDIDATES", QVariant(e.knownCandidates)},
+              {"SYNC_US", QVariant(static_cast<qlonglong>(e.sync.count()))},
+              {"SPECTRA_US", QVariant(static_cast<qlonglong>(e.spectra.count()))},
+              {"DOWNSAMPLE_US", QVariant(static_cast<qlonglong>(e.downsample.count()))},
+              {"DEMODULATE_US", QVariant(static_cast<qlonglong>(e.demodulate.count()))},
+              {"BP_US", QVariant(static_cast<qlonglong>(e.bp.count()))},
+              {"SUBTRACT_US", QVariant(static_cast<qlonglong>(e.subtract.count()))},
+              {"TOTAL_US", QVariant(static_cast<qlonglong>(e.total.count()))},
+          });
+        }
+
+        // Work shed to meet the deadline means the machine isn't keeping up
+        // with the submodes enabled; that's worth knowing without debugging.
+
+        if (e.skippedPasses || e.skippedCandidates)
+        {
+          qCWarning(decoderstats_js8) << JS8::Submode::name(e.mode)
+                                      << "decode over budget; skipped"
+                                      << e.skippedPasses     << "passes and"
+                                      << e.skippedCandidates << "candidates";
+        }
+      }
       else if constexpr (std::is_same_v<T, JS8::Event::DecodeFinished>)
       {
         qCDebug(decoder_js8) << "decode duration" << m_decoderBusyStartTime.msecsTo(QDateTime::currentDateTimeUtc()) << "ms";
 
+        if (decoder_js8().isDebugEnabled())
+        {
+          for (auto const & footprint : m_decoder.footprint())
+          {
+            qCDebug(decoder_js8) << "decoder submode" << footprint.mode
+                                 << "resident" << footprint.resident
+                                 << "bytes" << footprint.bytes
+                                 << "plan time" << footprint.planTime.count() << "us";
+          }
+        }
+
         // TODO: move this into a function
         if(!driftQueue.isEmpty())
         {
@@ -6199,11 +6479,30 @@ MainWindow::setupJS8()
   m_wideGraph->setPeriod(m_TRperiod);
   m_detector->setTRPeriod(JS8_NTMAX); // TODO - not thread safe
 
+  // let the decoders know which submodes we'll be decoding, so that they
+  // can release the resources held for any others
+  m_decoder.setSubmodes(decodeSubmodes());
+  if (m_secondaryDecoder) m_secondaryDecoder->setSubmodes(decodeSubmodes());
+
   updateTextDisplay();
   refreshTextDisplay();
   statusChanged();
 }
 
+// Set of submodes, in terms of decode submode bits, that we're decoding.
+
+int
+MainWindow::decodeSubmodes() const
+{
+  return ui->actionModeMultiDecoder->isChecked()
+       ? (JS8_ENABLE_JS8A ? 1 << 0 : 0) |
+         (JS8_ENABLE_JS8B ? 1 << 1 : 0) |
+         (JS8_ENABLE_JS8C ? 1 << 2 : 0) |
+         (JS8_ENABLE_JS8E ? 1 << 3 : 0) |
+         (JS8_ENABLE_JS8I ? 1 << 4 : 0)
+       : m_nSubMode == Varicode::JS8CallNormal ? 1 : m_nSubMode << 1;
+}
+
 void
 MainWindow::setFreq(int const n)
 {
@@ -7692,6 +7991,7 @@ void MainWindow::onDriftChanged(qint64 /*new_drift_ms*/){
     // this makes the detected emit the correct k when drifting time
     qCDebug(mainwindow_js8) << "Processing drift change.";
     m_detector->resetBufferPosition();
+    if (m_secondaryDetector) m_secondaryDetector->resetBufferPosition();
 }
 
 void MainWindow::setFreqOffsetForRestore(int freq, bool shouldRestore){
@@ -11484,4 +11784,5 @@ MainWindow::wisdomFileName() const
 }
 
 Q_LOGGING_CATEGORY(decoder_js8, "decoder.js8", QtWarningMsg)
+Q_LOGGING_CATEGORY(decoderstats_js8, "decoderstats.js8", QtWarningMsg)
 Q_LOGGING_CATEGORY(mainwindow_js8, "mainwindow.js8", QtWarningMsg)
@@ -56,6 +56,7 @@
 #include "NotificationAudio.h"
 #include "ProcessThread.h"
 #include "JS8.hpp"
+#include "FFTWPlans.hpp"
 #include "StationList.hpp"
 
 extern int volatile itone[JS8_NUM_SYMBOLS];   //Audio tones for all Tx symbols
@@ -132,6 +133,7 @@ public slots:
   void showSoundOutError(const QString& errorMsg);
   void showStatusMessage(const QString& statusMsg);
   void dataSink(qint64 frames);
+  void secondaryDataSink(qint64 frames);
   /**
    * The name `guiUpdate` suggests updating of the views from the models
    * (in MVC terms, but we don't do MVC in this project), animations and stuff.
@@ -184,6 +186,7 @@ public slots:
   QPair<QString, int> popMessageFrame();
   void tryNotify(const QString &key);
   void processDecodeEvent(JS8::Event::Variant const &);
+  void processSecondaryDecodeEvent(JS8::Event::Variant const &);
 
   void updateCQButtonDisplay();
   void updateHBButtonDisplay();
@@ -243,6 +246,7 @@ private slots:
   bool decodeEnqueueReadyExperiment(qint32 k, qint32 k0);
   bool decodeProcessQueue(qint32 *pSubmode);
   void decodeStart();
+  void decodePrime(qint32 k);
   void decodeBusy(bool b);
   void decodeDone ();
   void on_startTxButton_toggled(bool checked);
@@ -448,6 +452,18 @@ private:
   QString m_lastBand;
 
   Detector * m_detector;
+
+  // Secondary receiver, to which the detector feeds the other channel of
+  // a stereo input when the input channel is set to both; it has its own
+  // capture buffer, detector, and decoder, which exist only while the
+  // input channel is set to both, and decodes the same spans as the
+  // primary does. Its decodes are logged to ALL.TXT, with the dial
+  // frequency from the configuration, and appear nowhere else.
+  QScopedPointer<JS8::Capture> m_secondaryCapture;
+  Detector *                   m_secondaryDetector = nullptr;
+  QScopedPointer<JS8::Decoder> m_secondaryDecoder;
+  bool                         m_secondaryDecoderBusy = false;
+  qint64                       m_secondaryK0          = 0;
   unsigned m_FFTSize;
   SoundInput * m_soundInput;
   Modulator * m_modulator;
@@ -503,6 +519,8 @@ private:
   bool    m_isTimeToSend;
 
   int			m_ihsym;
+  std::unique_ptr<fftwf_complex[], void (*)(void *)> m_spectrumData {nullptr, fftwf_free};
+  FFTW::Plan m_spectrumPlan;
   float		m_px;
   float   m_pxmax;
   float		m_df3;
@@ -654,6 +672,7 @@ private:
       int submode;
       int start;
       int sz;
+      bool complete = false; // window has just received a full transmission
   };
 
   struct FrameCacheKey
@@ -686,6 +705,7 @@ private:
 
   QQueue<DecodeParams> m_decoderQueue;
   FrameCache  m_messageDupeCache; // submode, frame -> date seen
+  FrameCache  m_secondaryDupeCache; // as above, for the secondary receiver
   QVariantMap m_showColumnsCache; // table column:key -> show boolean
   QVariantMap m_sortCache; // table key -> sort by
   QPriorityQueue<PrioritizedMessage> m_txMessageQueue; // messages to be sent
@@ -835,6 +855,8 @@ private:
   void add_child_to_event_filter (QObject *);
   void remove_child_from_event_filter (QObject *);
   void setup_status_bar ();
+  void setSecondaryReceiver (bool enabled);
+  int decodeSubmodes () const;
   QString columnLabel(QString defaultLabel);
 
   void resetIdleTimer();
@@ -3,6 +3,7 @@
 #include <QAudioFormat>
 #include <QSysInfo>
 #include <QLoggingCategory>
+#include "Decimator.hpp"
 #include "DriftingDateTime.h"
 
 #include "moc_soundin.cpp"
@@ -54,7 +55,12 @@ void SoundInput::start(QAudioDevice const& device, int framesPerBuffer, AudioDev
 //  qCDebug (soundin_js8) << "Preferred audio input format:" << format;
   format.setSampleFormat (QAudioFormat::Int16);
   format.setChannelCount (AudioDevice::Mono == channel ? 1 : 2);
-  format.setSampleRate (48000);
+  // Capture at the device's native rate if the detector can decimate
+  // from it, sparing the audio system a resample; 48kHz otherwise.
+  if (!Decimator::supports (format.sampleRate ()) || !device.isFormatSupported (format))
+    {
+      format.setSampleRate (48000);
+    }
   if (!format.isValid ())
     {
       Q_EMIT error (tr ("Requested input audio format is not valid."));
@@ -78,6 +84,7 @@ void SoundInput::start(QAudioDevice const& device, int framesPerBuffer, AudioDev
   connect (m_stream.data(), &QAudioSource::stateChanged, this, &SoundInput::handleStateChanged);
 
   m_stream->setBufferSize (m_stream->format ().bytesForFrames (framesPerBuffer));
+  sink->setSampleRate (m_stream->format ().sampleRate ());
   if (sink->initialize (QIODevice::WriteOnly, channel))
     {
       m_stream->start (sink);